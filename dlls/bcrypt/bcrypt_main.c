@@ -453,10 +453,10 @@ struct hash
     enum alg_id       alg_id;
     const struct ltc_hash_descriptor *desc;
     ULONG             flags;
-    UCHAR            *secret;
-    ULONG             secret_len;
     hash_state        outer;
     hash_state        inner;
+    hash_state        hmac_outer; /* keyed states, restored on each reset */
+    hash_state        hmac_inner;
 };
 
 #define BLOCK_LENGTH_RC4        1
@@ -887,40 +887,45 @@ NTSTATUS WINAPI BCryptGetProperty( BCRYPT_HANDLE handle, const WCHAR *prop, UCHA
 }
 
 static void hash_prepare( struct hash *hash )
+{
+    if (!(hash->flags & HASH_FLAG_HMAC))
+    {
+        hash->desc->init( &hash->inner );
+        return;
+    }
+    hash->inner = hash->hmac_inner;
+    hash->outer = hash->hmac_outer;
+}
+
+static void hmac_prepare( struct hash *hash, UCHAR *secret, ULONG secret_len )
 {
     UCHAR buffer[MAX_HASH_BLOCK_BITS / 8] = {0};
     int block_bytes, i;
 
-    /* initialize hash */
-    hash->desc->init( &hash->inner );
-    if (!(hash->flags & HASH_FLAG_HMAC)) return;
-
-    /* initialize hmac */
-    hash->desc->init( &hash->outer );
+    hash->desc->init( &hash->hmac_inner );
+    hash->desc->init( &hash->hmac_outer );
     block_bytes = hash->desc->blocksize;
-    if (hash->secret_len > block_bytes)
+    if (secret_len > block_bytes)
     {
         hash_state temp;
         hash->desc->init( &temp );
-        hash->desc->process( &temp, hash->secret, hash->secret_len );
+        hash->desc->process( &temp, secret, secret_len );
         hash->desc->done( &temp, buffer );
     }
-    else memcpy( buffer, hash->secret, hash->secret_len );
+    else memcpy( buffer, secret, secret_len );
 
     for (i = 0; i < block_bytes; i++) buffer[i] ^= 0x5c;
-    hash->desc->process( &hash->outer, buffer, block_bytes );
+    hash->desc->process( &hash->hmac_outer, buffer, block_bytes );
     for (i = 0; i < block_bytes; i++) buffer[i] ^= (0x5c ^ 0x36);
-    hash->desc->process( &hash->inner, buffer, block_bytes );
+    hash->desc->process( &hash->hmac_inner, buffer, block_bytes );
 }
 
-static NTSTATUS hash_create( const struct algorithm *alg, UCHAR *secret, ULONG secret_len, ULONG flags,
-                             struct hash **ret_hash )
+static NTSTATUS hash_init( struct hash *hash, const struct algorithm *alg, UCHAR *secret, ULONG secret_len,
+                           ULONG flags )
 {
-    struct hash *hash;
     const struct ltc_hash_descriptor *desc = get_hash_descriptor( alg->id );
 
     if (!desc) return STATUS_NOT_IMPLEMENTED;
-    if (!(hash = calloc( 1, sizeof(*hash) ))) return STATUS_NO_MEMORY;
     hash->hdr.magic = MAGIC_HASH;
     hash->alg_id    = alg->id;
     hash->desc      = desc;
@@ -928,15 +933,24 @@ static NTSTATUS hash_create( const struct algorithm *alg, UCHAR *secret, ULONG s
     if ((alg->flags & BCRYPT_HASH_REUSABLE_FLAG) || (flags & BCRYPT_HASH_REUSABLE_FLAG))
         hash->flags |= HASH_FLAG_REUSABLE;
 
-    if (secret_len && !(hash->secret = malloc( secret_len )))
+    /* the key is only needed to compute the keyed states, which are kept instead */
+    if (hash->flags & HASH_FLAG_HMAC) hmac_prepare( hash, secret, secret_len );
+    hash_prepare( hash );
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS hash_create( const struct algorithm *alg, UCHAR *secret, ULONG secret_len, ULONG flags,
+                             struct hash **ret_hash )
+{
+    struct hash *hash;
+    NTSTATUS status;
+
+    if (!(hash = calloc( 1, sizeof(*hash) ))) return STATUS_NO_MEMORY;
+    if ((status = hash_init( hash, alg, secret, secret_len, flags )))
     {
         free( hash );
-        return STATUS_NO_MEMORY;
+        return status;
     }
-    memcpy( hash->secret, secret, secret_len );
-    hash->secret_len = secret_len;
-
-    hash_prepare( hash );
     *ret_hash = hash;
     return STATUS_SUCCESS;
 }
@@ -980,12 +994,6 @@ NTSTATUS WINAPI BCryptDuplicateHash( BCRYPT_HASH_HANDLE handle, BCRYPT_HASH_HAND
     if (!(hash_copy = malloc( sizeof(*hash_copy) ))) return STATUS_NO_MEMORY;
 
     memcpy( hash_copy, hash_orig, sizeof(*hash_orig) );
-    if (hash_orig->secret && !(hash_copy->secret = malloc( hash_orig->secret_len )))
-    {
-        free( hash_copy );
-        return STATUS_NO_MEMORY;
-    }
-    memcpy( hash_copy->secret, hash_orig->secret, hash_orig->secret_len );
 
     *handle_copy = hash_copy;
     TRACE( "returning handle %p\n", *handle_copy );
@@ -995,7 +1003,6 @@ NTSTATUS WINAPI BCryptDuplicateHash( BCRYPT_HASH_HANDLE handle, BCRYPT_HASH_HAND
 static void hash_destroy( struct hash *hash )
 {
     if (!hash) return;
-    free( hash->secret );
     destroy_object( &hash->hdr );
 }
 
@@ -1057,17 +1064,13 @@ NTSTATUS WINAPI BCryptFinishHash( BCRYPT_HASH_HANDLE handle, UCHAR *output, ULON
 static NTSTATUS hash_single( struct algorithm *alg, UCHAR *secret, ULONG secret_len, UCHAR *input, ULONG input_len,
                              UCHAR *output, ULONG output_len )
 {
-    struct hash *hash;
+    struct hash hash = {{ 0 }};
     NTSTATUS status;
 
-    if ((status = hash_create( alg, secret, secret_len, 0, &hash ))) return status;
-    if (input_len && hash->desc->process( &hash->inner, input, input_len ))
-    {
-        hash_destroy( hash );
-        return STATUS_INVALID_PARAMETER;
-    }
-    hash_finalize( hash, output );
-    hash_destroy( hash );
+    /* one-shot hashes never escape, avoid the allocation */
+    if ((status = hash_init( &hash, alg, secret, secret_len, 0 ))) return status;
+    if (input_len && hash.desc->process( &hash.inner, input, input_len )) return STATUS_INVALID_PARAMETER;
+    hash_finalize( &hash, output );
     return STATUS_SUCCESS;
 }
 
@@ -194,7 +194,7 @@ struct hash_test
 static void test_hash(const struct hash_test *test)
 {
     BCRYPT_ALG_HANDLE alg;
-    BCRYPT_HASH_HANDLE hash;
+    BCRYPT_HASH_HANDLE hash, hash2;
     UCHAR buf[512], buf_hmac[1024], hash_buf[128], hmac_hash[128];
     char str[512];
     NTSTATUS ret;
@@ -291,6 +291,32 @@ static void test_hash(const struct hash_test *test)
     ret = BCryptDestroyHash(hash);
     ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
 
+    hash = NULL;
+    len = sizeof(buf_hmac);
+    ret = BCryptCreateHash(alg, &hash, buf_hmac, len, (UCHAR *)"key", sizeof("key"), 0);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
+    ret = BCryptHashData(hash, (UCHAR *)"test", sizeof("test"), 0);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
+    hash2 = NULL;
+    ret = BCryptDuplicateHash(hash, &hash2, NULL, 0, 0);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+    ok(hash2 != NULL, "hash not set\n");
+
+    /* the copy keeps working after the original is gone */
+    ret = BCryptDestroyHash(hash);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
+    memset(hmac_hash, 0, sizeof(hmac_hash));
+    ret = BCryptFinishHash(hash2, hmac_hash, test->hash_size, 0);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+    format_hash( hmac_hash, test->hash_size, str );
+    ok(!strcmp(str, test->hmac_hash), "got %s\n", str);
+
+    ret = BCryptDestroyHash(hash2);
+    ok(ret == STATUS_SUCCESS, "got %#lx\n", ret);
+
     hash = NULL;
     len = sizeof(buf_hmac);
     ret = BCryptCreateHash(alg, &hash, buf_hmac, len, (UCHAR *)"key", sizeof("key"), BCRYPT_HASH_REUSABLE_FLAG);
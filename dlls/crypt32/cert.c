@@ -1629,20 +1629,35 @@ static BOOL compare_cert_by_signature_hash(PCCERT_CONTEXT pCertContext, DWORD dw
     return ret;
 }
 
+struct cert_compare_params
+{
+    CertCompareFunc compare;
+    DWORD           dwType;
+    DWORD           dwFlags;
+    const void     *pvPara;
+};
+
+static BOOL cert_match(PCCERT_CONTEXT pCertContext, const void *param)
+{
+    const struct cert_compare_params *params = param;
+
+    return params->compare(pCertContext, params->dwType, params->dwFlags,
+     params->pvPara);
+}
+
 static inline PCCERT_CONTEXT cert_compare_certs_in_store(HCERTSTORE store,
  PCCERT_CONTEXT prev, CertCompareFunc compare, DWORD dwType, DWORD dwFlags,
  const void *pvPara)
 {
-    BOOL matches = FALSE;
-    PCCERT_CONTEXT ret;
+    struct cert_compare_params params = { compare, dwType, dwFlags, pvPara };
+    WINECRYPT_CERTSTORE *hcs = store;
+    context_t *ret;
 
-    ret = prev;
-    do {
-        ret = CertEnumCertificatesInStore(store, ret);
-        if (ret)
-            matches = compare(ret, dwType, dwFlags, pvPara);
-    } while (ret != NULL && !matches);
-    return ret;
+    if (!hcs || hcs->dwMagic != WINE_CRYPTCERTSTORE_MAGIC)
+        return NULL;
+    ret = CRYPT_FindCertificateInStore(hcs, prev ? &cert_from_ptr(prev)->base : NULL,
+     cert_match, &params);
+    return ret ? context_ptr(ret) : NULL;
 }
 
 typedef PCCERT_CONTEXT (*CertFindFunc)(HCERTSTORE store, DWORD dwType,
@@ -257,6 +257,51 @@ static context_t *Collection_enumCert(WINECRYPT_CERTSTORE *store, context_t *pre
     return ret;
 }
 
+/* Searches the child stores directly, so that a link context is only created
+ * for the matching certificate rather than for every enumerated one.
+ */
+static context_t *Collection_findCert(WINECRYPT_CERTSTORE *store, context_t *prev,
+ CertMatchFunc match, const void *param)
+{
+    WINE_COLLECTIONSTORE *cs = (WINE_COLLECTIONSTORE*)store;
+    WINE_STORE_LIST_ENTRY *storeEntry;
+    context_t *child = NULL, *ret = NULL;
+    struct list *next;
+
+    TRACE("(%p, %p)\n", store, prev);
+
+    EnterCriticalSection(&cs->cs);
+    if (prev)
+    {
+        storeEntry = prev->u.ptr;
+        child = prev->linked;
+        Context_AddRef(child);
+        Context_Release(prev);
+        next = &storeEntry->entry;
+    }
+    else
+        next = list_head(&cs->stores);
+
+    while (next)
+    {
+        storeEntry = LIST_ENTRY(next, WINE_STORE_LIST_ENTRY, entry);
+        child = CRYPT_FindCertificateInStore(storeEntry->store, child, match, param);
+        if (child)
+        {
+            ret = CRYPT_CollectionCreateContextFromChild(cs, storeEntry, child);
+            Context_Release(child);
+            break;
+        }
+        next = list_next(&cs->stores, next);
+    }
+    LeaveCriticalSection(&cs->cs);
+
+    if (!ret)
+        SetLastError(CRYPT_E_NOT_FOUND);
+    TRACE("returning %p\n", ret);
+    return ret;
+}
+
 static BOOL Collection_deleteCert(WINECRYPT_CERTSTORE *store, context_t *context)
 {
     cert_t *cert = (cert_t*)context;
@@ -458,7 +503,8 @@ static const store_vtbl_t CollectionStoreVtbl = {
         Collection_addCTL,
         Collection_enumCTL,
         Collection_deleteCTL
-    }
+    },
+    Collection_findCert
 };
 
 WINECRYPT_CERTSTORE *CRYPT_CollectionOpenStore(HCRYPTPROV hCryptProv,
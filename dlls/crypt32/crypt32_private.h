@@ -311,8 +311,12 @@ typedef enum _CertStoreType {
  * - closeStore is called when the store's ref count becomes 0
  * - control is optional, but should be implemented by any store that supports
  *   persistence
+ * - findCert is optional, stores which don't implement it are searched by
+ *   enumerating their certificates
  */
 
+typedef BOOL (*CertMatchFunc)(PCCERT_CONTEXT cert, const void *param);
+
 typedef struct {
     void (*addref)(struct WINE_CRYPTCERTSTORE*);
     DWORD (*release)(struct WINE_CRYPTCERTSTORE*,DWORD);
@@ -321,6 +325,7 @@ typedef struct {
     CONTEXT_FUNCS certs;
     CONTEXT_FUNCS crls;
     CONTEXT_FUNCS ctls;
+    context_t *(*findCert)(struct WINE_CRYPTCERTSTORE*,context_t*,CertMatchFunc,const void*);
 } store_vtbl_t;
 
 typedef struct WINE_CRYPTCERTSTORE
@@ -426,6 +431,12 @@ context_t *Context_CreateLinkContext(unsigned contextSize, context_t *linked, st
 
 BOOL CRYPT_DeleteCertificateFromStore(PCCERT_CONTEXT pCertContext);
 
+/* Returns the next certificate after prev for which match returns TRUE, like
+ * CertEnumCertificatesInStore prev is released.
+ */
+context_t *CRYPT_FindCertificateInStore(WINECRYPT_CERTSTORE *store, context_t *prev,
+ CertMatchFunc match, const void *param);
+
 /* Copies properties from fromContext to toContext. */
 void Context_CopyProperties(const void *to, const void *from);
 
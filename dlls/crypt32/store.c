@@ -978,6 +978,20 @@ PCCERT_CONTEXT WINAPI CertEnumCertificatesInStore(HCERTSTORE hCertStore, PCCERT_
     return ret ? &ret->ctx : NULL;
 }
 
+context_t *CRYPT_FindCertificateInStore(WINECRYPT_CERTSTORE *store, context_t *prev,
+ CertMatchFunc match, const void *param)
+{
+    context_t *ret = prev;
+
+    if (store->vtbl->findCert)
+        return store->vtbl->findCert(store, prev, match, param);
+
+    while ((ret = store->vtbl->certs.enumContext(store, ret)))
+        if (match(context_ptr(ret), param))
+            break;
+    return ret;
+}
+
 BOOL CRYPT_DeleteCertificateFromStore(PCCERT_CONTEXT pCertContext)
 {
     WINECRYPT_CERTSTORE *hcs;
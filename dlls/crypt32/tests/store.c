@@ -551,6 +551,9 @@ static void testStoresInCollection(void)
 {
     PCCERT_CONTEXT cert1, cert2, tcert1;
     HCERTSTORE collection, ro_store, rw_store, rw_store_2, tstore;
+    CRYPT_HASH_BLOB blob;
+    BYTE hash[20];
+    DWORD size;
     BOOL ret;
 
     collection = CertOpenStore(CERT_STORE_PROV_COLLECTION, 0, 0,
@@ -629,6 +632,21 @@ static void testStoresInCollection(void)
     tcert1 = CertEnumCertificatesInStore(collection, tcert1);
     ok (tcert1==NULL,"Unexpected cert in the collection %p %lx\n",tcert1, GetLastError());
 
+    /** finding a certificate goes through the stores of the collection */
+    size = sizeof(hash);
+    ret = CertGetCertificateContextProperty(cert1, CERT_SHA1_HASH_PROP_ID, hash, &size);
+    ok (ret, "Failed to get cert1 hash %lx\n", GetLastError());
+    blob.cbData = size;
+    blob.pbData = hash;
+    tcert1 = CertFindCertificateInStore(collection, X509_ASN_ENCODING, 0, CERT_FIND_SHA1_HASH, &blob, NULL);
+    ok (tcert1 && tcert1->cbCertEncoded == cert1->cbCertEncoded,
+        "cert1 expected in the collection got %p, %lx\n", tcert1, GetLastError());
+    ok (tcert1 && tcert1->hCertStore == collection, "Unexpected store %p\n", tcert1 ? tcert1->hCertStore : NULL);
+    SetLastError(0xdeadbeef);
+    tcert1 = CertFindCertificateInStore(collection, X509_ASN_ENCODING, 0, CERT_FIND_SHA1_HASH, &blob, tcert1);
+    ok (!tcert1 && GetLastError() == CRYPT_E_NOT_FOUND,
+        "Unexpected cert in the collection %p %lx\n", tcert1, GetLastError());
+
     /* checking whether certs had been saved */
     tstore = CertOpenStore(CERT_STORE_PROV_SYSTEM_REGISTRY_W, 0, 0,
         CERT_SYSTEM_STORE_CURRENT_USER | CERT_STORE_OPEN_EXISTING_FLAG, L"WineTest_RW");
@@ -50,6 +50,7 @@ static HTTP_REQUEST_ID req_id_counter;
 struct connection
 {
     struct list entry; /* in "connections" below */
+    struct list id_entry; /* in "request_ids" below, if "req_id" is set */
 
     SOCKET socket;
 
@@ -84,6 +85,19 @@ struct connection
 
 static struct list connections = LIST_INIT(connections);
 
+/* Connections with a request ID, hashed by it, so that the IRPs referring to
+ * a request don't need to look through every connection. */
+#define REQUEST_ID_BUCKETS 64
+static struct list request_ids[REQUEST_ID_BUCKETS];
+
+static void set_request_id(struct connection *conn, HTTP_REQUEST_ID req_id)
+{
+    if (conn->req_id)
+        list_remove(&conn->id_entry);
+    if ((conn->req_id = req_id))
+        list_add_tail(&request_ids[req_id % REQUEST_ID_BUCKETS], &conn->id_entry);
+}
+
 struct listening_socket
 {
     struct list entry;
@@ -93,9 +107,30 @@ struct listening_socket
 
 static struct list listening_sockets = LIST_INIT(listening_sockets);
 
+/* URLs are kept in a trie of their path segments, so that finding the URL
+ * matching a request only needs to walk the segments of the request path. */
+struct url_node
+{
+    struct list entry; /* in the parent's "children" */
+    struct list children;
+    struct list urls; /* URLs with exactly this path */
+    struct url_node *parent;
+    size_t len;
+    char segment[1];
+};
+
+static struct url_node url_root =
+{
+    .children = LIST_INIT(url_root.children),
+    .urls = LIST_INIT(url_root.urls),
+};
+
 struct url
 {
     struct list entry;
+    struct list node_entry; /* in the "urls" of "node" */
+    struct url_node *node;
+    struct request_queue *queue;
     char *url;
     HTTP_URL_CONTEXT context;
     struct listening_socket *listening_sock;
@@ -110,6 +145,74 @@ struct request_queue
 
 static struct list request_queues = LIST_INIT(request_queues);
 
+/* Return the end of a path, leaving out the query and a trailing slash. */
+static const char *get_path_end(const char *path, const char *end)
+{
+    const char *query;
+
+    if ((query = memchr(path, '?', end - path)))
+        end = query;
+    if (end > path && end[-1] == '/')
+        --end;
+    return end;
+}
+
+static struct url_node *get_url_node_child(struct url_node *node, const char *segment, size_t len)
+{
+    struct url_node *child;
+
+    LIST_FOR_EACH_ENTRY(child, &node->children, struct url_node, entry)
+    {
+        if (child->len == len && !memcmp(child->segment, segment, len))
+            return child;
+    }
+    return NULL;
+}
+
+/* Remove a node and its parents from the trie once they have no URL left. */
+static void release_url_node(struct url_node *node)
+{
+    struct url_node *parent;
+
+    while (node != &url_root && list_empty(&node->urls) && list_empty(&node->children))
+    {
+        parent = node->parent;
+        list_remove(&node->entry);
+        free(node);
+        node = parent;
+    }
+}
+
+/* Find the trie node for a path, creating it if it doesn't exist yet. */
+static struct url_node *create_url_node(const char *path, const char *end)
+{
+    struct url_node *node = &url_root, *child;
+    const char *segment;
+
+    while (path < end)
+    {
+        segment = ++path;
+        while (path < end && *path != '/') ++path;
+
+        if (!(child = get_url_node_child(node, segment, path - segment)))
+        {
+            if (!(child = malloc(offsetof(struct url_node, segment[path - segment]))))
+            {
+                release_url_node(node);
+                return NULL;
+            }
+            list_init(&child->children);
+            list_init(&child->urls);
+            child->parent = node;
+            child->len = path - segment;
+            memcpy(child->segment, segment, child->len);
+            list_add_tail(&node->children, &child->entry);
+        }
+        node = child;
+    }
+    return node;
+}
+
 static void accept_connection(SOCKET socket)
 {
     struct connection *conn;
@@ -153,6 +256,7 @@ static void close_connection(struct connection *conn)
     if (!conn->shutdown)
         shutdown_connection(conn);
     closesocket(conn->socket);
+    set_request_id(conn, HTTP_NULL_ID);
     list_remove(&conn->entry);
     free(conn);
 }
@@ -303,7 +407,7 @@ static NTSTATUS complete_irp(struct connection *conn, IRP *irp)
     TRACE("Completing IRP %p.\n", irp);
 
     if (!conn->req_id)
-        conn->req_id = ++req_id_counter;
+        set_request_id(conn, ++req_id_counter);
 
     if (params.bits == 32)
         return complete_irp_32(conn, irp);
@@ -344,40 +448,6 @@ static int parse_number(const char *str, const char **endptr, const char *end)
 }
 
 
-/* 0 means not a match, 1 and higher means a match, higher means more paths matched. */
-static unsigned int compare_paths(const char *queue_path, const char *conn_path, size_t conn_len)
-{
-    const char *question_mark;
-    unsigned int i, cnt = 1;
-    size_t queue_len;
-
-    queue_len = strlen(queue_path);
-
-    if ((question_mark = memchr(conn_path, '?', conn_len)))
-        conn_len = question_mark - conn_path;
-
-    if (queue_path[queue_len - 1] == '/')
-        queue_len--;
-    if (conn_path[conn_len - 1] == '/')
-        conn_len--;
-
-    if (conn_len < queue_len)
-        return 0;
-
-    for (i = 0; i < queue_len; ++i)
-    {
-        if (queue_path[i] != conn_path[i])
-            return 0;
-        if (queue_path[i] == '/')
-            cnt++;
-    }
-
-    if (queue_len == conn_len || conn_path[queue_len] == '/')
-        return cnt;
-    else
-        return 0;
-}
-
 static BOOL host_matches(const struct url *url, const char *conn_host)
 {
     size_t host_len;
@@ -402,46 +472,45 @@ static BOOL host_matches(const struct url *url, const char *conn_host)
     return FALSE;
 }
 
-static struct url *url_matches(const struct connection *conn, const struct request_queue *queue,
-                                unsigned int *ret_slash_count)
+/* Find the URL with the longest path matching the request. */
+static struct url *match_url(const struct connection *conn)
 {
-    const char *queue_path, *conn_host, *conn_path;
-    unsigned int max_slash_count = 0, slash_count;
-    size_t conn_path_len;
+    const char *conn_host, *path, *end, *segment;
+    struct url_node *node = &url_root;
     struct url *url, *ret = NULL;
 
+    end = conn->url + conn->url_len;
     if (conn->url[0] == '/')
     {
         conn_host = conn->host;
-        conn_path = conn->url;
-        conn_path_len = conn->url_len;
-
+        path = conn->url;
     }
     else
     {
         conn_host = conn->url + 7;
-        conn_path = strchr(conn_host, '/');
-        conn_path_len = (conn->url + conn->url_len) - conn_path;
+        if (!(path = memchr(conn_host, '/', end - conn_host)))
+            return NULL;
     }
+    end = get_path_end(path, end);
 
-    LIST_FOR_EACH_ENTRY(url, &queue->urls, struct url, entry)
+    for (;;)
     {
-        if (host_matches(url, conn_host))
+        LIST_FOR_EACH_ENTRY(url, &node->urls, struct url, node_entry)
         {
-            queue_path = strchr(url->url + 7, '/');
-            if (!queue_path)
-                continue;
-            slash_count = compare_paths(queue_path, conn_path, conn_path_len);
-            if (slash_count > max_slash_count)
+            if (host_matches(url, conn_host))
             {
-                max_slash_count = slash_count;
                 ret = url;
+                break;
             }
         }
-    }
 
-    if (ret_slash_count)
-        *ret_slash_count = max_slash_count;
+        if (path >= end)
+            break;
+        segment = ++path;
+        while (path < end && *path != '/') ++path;
+        if (!(node = get_url_node_child(node, segment, path - segment)))
+            break;
+    }
 
     return ret;
 }
@@ -452,10 +521,8 @@ static struct url *url_matches(const struct connection *conn, const struct reque
 static int parse_request(struct connection *conn)
 {
     const char *const req = conn->buffer, *const end = conn->buffer + conn->len;
-    struct request_queue *queue, *best_queue = NULL;
-    struct url *conn_url, *best_conn_url = NULL;
     const char *p = req, *q;
-    unsigned int slash_count, best_slash_count = 0;
+    struct url *url;
     int len, ret;
 
     if (!conn->len) return 0;
@@ -546,24 +613,11 @@ static int parse_request(struct connection *conn)
 
     conn->queue = NULL;
     /* Find a queue which can receive this request. */
-    LIST_FOR_EACH_ENTRY(queue, &request_queues, struct request_queue, entry)
+    if ((url = match_url(conn)))
     {
-        if ((conn_url = url_matches(conn, queue, &slash_count)))
-        {
-            if (slash_count > best_slash_count)
-            {
-                best_slash_count = slash_count;
-                best_queue = queue;
-                best_conn_url = conn_url;
-            }
-        }
-    }
-
-    if (best_conn_url)
-    {
-        TRACE("Assigning request to queue %p.\n", best_queue);
-        conn->queue = best_queue;
-        conn->context = best_conn_url->context;
+        TRACE("Assigning request to queue %p.\n", url->queue);
+        conn->queue = url->queue;
+        conn->context = url->context;
     }
 
     /* Stop selecting on incoming data until a response is queued. */
@@ -679,9 +733,8 @@ static void receive_data(struct connection *conn)
 
 static DWORD WINAPI request_thread_proc(void *arg)
 {
+    struct listening_socket *listening_sock;
     struct connection *conn, *cursor;
-    struct request_queue *queue;
-    struct url *url;
 
     TRACE("Starting request thread.\n");
 
@@ -689,13 +742,11 @@ static DWORD WINAPI request_thread_proc(void *arg)
     {
         EnterCriticalSection(&http_cs);
 
-        LIST_FOR_EACH_ENTRY(queue, &request_queues, struct request_queue, entry)
+        /* Several URLs usually share a listening socket, only try it once. */
+        LIST_FOR_EACH_ENTRY(listening_sock, &listening_sockets, struct listening_socket, entry)
         {
-            LIST_FOR_EACH_ENTRY(url, &queue->urls, struct url, entry)
-            {
-                if (url->listening_sock && url->listening_sock->socket != -1)
-                    accept_connection(url->listening_sock->socket);
-            }
+            if (listening_sock->socket != -1)
+                accept_connection(listening_sock->socket);
         }
 
         LIST_FOR_EACH_ENTRY_SAFE(conn, cursor, &connections, struct connection, entry)
@@ -727,12 +778,12 @@ static struct listening_socket *get_listening_socket(unsigned short port)
 static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
 {
     const struct http_add_url_params *params = irp->AssociatedIrp.SystemBuffer;
-    struct request_queue *queue_entry;
     struct sockaddr_in addr;
     struct connection *conn;
-    struct url *url_entry, *new_entry;
+    struct url *url_entry, *new_entry, *conn_url;
     struct listening_socket *listening_sock;
-    char *url, *endptr;
+    struct url_node *node;
+    char *url, *endptr, *path;
     size_t queue_url_len, new_url_len;
     ULONG one = 1, value;
     SOCKET s = INVALID_SOCKET;
@@ -766,21 +817,28 @@ static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
 
     EnterCriticalSection(&http_cs);
 
-    LIST_FOR_EACH_ENTRY(queue_entry, &request_queues, struct request_queue, entry)
+    path = strchr(url + 7, '/');
+    if (!(node = create_url_node(path, get_path_end(path, path + strlen(path)))))
     {
-        LIST_FOR_EACH_ENTRY(url_entry, &queue_entry->urls, struct url, entry)
-        {
-            queue_url_len = strlen(url_entry->url);
-            if (url_entry->url[queue_url_len - 1] == '/')
-                queue_url_len--;
+        LeaveCriticalSection(&http_cs);
+        free(url);
+        free(new_entry);
+        return STATUS_NO_MEMORY;
+    }
 
-            if (url_entry->url && queue_url_len == new_url_len && !memcmp(url_entry->url, url, queue_url_len))
-            {
-                LeaveCriticalSection(&http_cs);
-                free(url);
-                free(new_entry);
-                return STATUS_OBJECT_NAME_COLLISION;
-            }
+    /* Identical URLs have the same path, so they are registered on this node. */
+    LIST_FOR_EACH_ENTRY(url_entry, &node->urls, struct url, node_entry)
+    {
+        queue_url_len = strlen(url_entry->url);
+        if (url_entry->url[queue_url_len - 1] == '/')
+            queue_url_len--;
+
+        if (queue_url_len == new_url_len && !memcmp(url_entry->url, url, queue_url_len))
+        {
+            LeaveCriticalSection(&http_cs);
+            free(url);
+            free(new_entry);
+            return STATUS_OBJECT_NAME_COLLISION;
         }
     }
 
@@ -791,6 +849,7 @@ static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
         if ((s = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET)
         {
             ERR("Failed to create socket, error %u.\n", WSAGetLastError());
+            release_url_node(node);
             LeaveCriticalSection(&http_cs);
             free(url);
             free(new_entry);
@@ -803,6 +862,7 @@ static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
         setsockopt(s, SOL_SOCKET, SO_EXCLUSIVEADDRUSE, (char *)&value, sizeof(value));
         if (bind(s, (struct sockaddr *)&addr, sizeof(addr)) == -1)
         {
+            release_url_node(node);
             LeaveCriticalSection(&http_cs);
             closesocket(s);
             free(url);
@@ -824,6 +884,7 @@ static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
         if (listen(s, SOMAXCONN) == -1)
         {
             ERR("Failed to listen to port %u, error %u.\n", addr.sin_port, WSAGetLastError());
+            release_url_node(node);
             LeaveCriticalSection(&http_cs);
             closesocket(s);
             free(url);
@@ -833,6 +894,7 @@ static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
 
         if (!(listening_sock = malloc(sizeof(struct listening_socket))))
         {
+            release_url_node(node);
             LeaveCriticalSection(&http_cs);
             closesocket(s);
             free(url);
@@ -850,15 +912,18 @@ static NTSTATUS http_add_url(struct request_queue *queue, IRP *irp)
     new_entry->url = url;
     new_entry->context = params->context;
     new_entry->listening_sock = listening_sock;
+    new_entry->queue = queue;
+    new_entry->node = node;
     list_add_head(&queue->urls, &new_entry->entry);
+    list_add_head(&node->urls, &new_entry->node_entry);
 
-    /* See if any pending requests now match this queue. */
+    /* See if any pending requests now match this URL. */
     LIST_FOR_EACH_ENTRY(conn, &connections, struct connection, entry)
     {
-        if (conn->available && !conn->queue && url_matches(conn, queue, NULL))
+        if (conn->available && !conn->queue && (conn_url = match_url(conn)))
         {
-            conn->queue = queue;
-            conn->context = params->context;
+            conn->queue = conn_url->queue;
+            conn->context = conn_url->context;
             try_complete_irp(conn);
         }
     }
@@ -900,8 +965,10 @@ static NTSTATUS http_remove_url(struct request_queue *queue, IRP *irp)
     {
         if (url_entry->url && !strcmp(url, url_entry->url))
         {
-            free(url_entry->url);
-            url_entry->url = NULL;
+            /* unlink the URL first, so that it doesn't keep its socket in use */
+            list_remove(&url_entry->entry);
+            list_remove(&url_entry->node_entry);
+            release_url_node(url_entry->node);
 
             if (!is_listening_socket_used(url_entry->listening_sock))
             {
@@ -910,9 +977,8 @@ static NTSTATUS http_remove_url(struct request_queue *queue, IRP *irp)
                 list_remove(&url_entry->listening_sock->entry);
                 free(url_entry->listening_sock);
             }
-            url_entry->listening_sock = NULL;
 
-            list_remove(&url_entry->entry);
+            free(url_entry->url);
             free(url_entry);
 
             LeaveCriticalSection(&http_cs);
@@ -928,7 +994,17 @@ static struct connection *get_connection(HTTP_REQUEST_ID req_id)
 {
     struct connection *conn;
 
-    LIST_FOR_EACH_ENTRY(conn, &connections, struct connection, entry)
+    if (req_id == HTTP_NULL_ID)
+    {
+        LIST_FOR_EACH_ENTRY(conn, &connections, struct connection, entry)
+        {
+            if (conn->req_id == req_id)
+                return conn;
+        }
+        return NULL;
+    }
+
+    LIST_FOR_EACH_ENTRY(conn, &request_ids[req_id % REQUEST_ID_BUCKETS], struct connection, id_entry)
     {
         if (conn->req_id == req_id)
             return conn;
@@ -1017,7 +1093,7 @@ static NTSTATUS http_send_response(struct request_queue *queue, IRP *irp)
                 }
 
                 conn->queue = NULL;
-                conn->req_id = HTTP_NULL_ID;
+                set_request_id(conn, HTTP_NULL_ID);
                 WSAEventSelect(conn->socket, request_event, FD_READ | FD_CLOSE);
 
                 /* We might have another request already in the buffer. */
@@ -1149,6 +1225,8 @@ static void close_queue(struct request_queue *queue)
 
     LIST_FOR_EACH_ENTRY_SAFE(url, url_next, &queue->urls, struct url, entry)
     {
+        list_remove(&url->node_entry);
+        release_url_node(url->node);
         free(url->url);
         free(url);
     }
@@ -1225,9 +1303,13 @@ NTSTATUS WINAPI DriverEntry(DRIVER_OBJECT *driver, UNICODE_STRING *path)
     UNICODE_STRING device_http_req_queue = RTL_CONSTANT_STRING(L"\\Device\\Http\\ReqQueue");
     WSADATA wsadata;
     NTSTATUS ret;
+    unsigned int i;
 
     TRACE("driver %p, path %s.\n", driver, debugstr_w(path->Buffer));
 
+    for (i = 0; i < REQUEST_ID_BUCKETS; i++)
+        list_init(&request_ids[i]);
+
     attr.ObjectName = &device_http;
     if ((ret = NtCreateDirectoryObject(&directory_obj, 0, &attr)) && ret != STATUS_OBJECT_NAME_COLLISION)
         ERR("Failed to create \\Device\\Http directory, status %#lx.\n", ret);
@@ -377,6 +377,99 @@ static void format_date(char *buffer)
             date.wYear, date.wHour, date.wMinute, date.wSecond);
 }
 
+/* Get the number of bytes that a data chunk adds to the entity body. */
+static ULONG get_chunk_size(const HTTP_DATA_CHUNK *chunk, ULONGLONG *size)
+{
+    const HTTP_BYTE_RANGE *range;
+    LARGE_INTEGER file_size;
+
+    switch (chunk->DataChunkType)
+    {
+    case HttpDataChunkFromMemory:
+        *size = chunk->FromMemory.BufferLength;
+        return ERROR_SUCCESS;
+
+    case HttpDataChunkFromFileHandle:
+        range = &chunk->FromFileHandle.ByteRange;
+        if (!GetFileSizeEx(chunk->FromFileHandle.FileHandle, &file_size))
+            return GetLastError();
+        if (range->StartingOffset.QuadPart > file_size.QuadPart)
+            return ERROR_INVALID_PARAMETER;
+        *size = file_size.QuadPart - range->StartingOffset.QuadPart;
+        if (range->Length.QuadPart != HTTP_BYTE_RANGE_TO_EOF && range->Length.QuadPart < *size)
+            *size = range->Length.QuadPart;
+        return ERROR_SUCCESS;
+
+    default:
+        FIXME("Unhandled data chunk type %u.\n", chunk->DataChunkType);
+        return ERROR_CALL_NOT_IMPLEMENTED;
+    }
+}
+
+/* Get the size of the entity body made of the given data chunks. */
+static ULONG get_body_size(const HTTP_DATA_CHUNK *chunks, USHORT count, int *len)
+{
+    ULONGLONG size;
+    ULONG ret;
+    USHORT i;
+
+    *len = 0;
+    for (i = 0; i < count; ++i)
+    {
+        if ((ret = get_chunk_size(&chunks[i], &size)))
+            return ret;
+        if (size > INT_MAX - *len)
+            return ERROR_NOT_ENOUGH_MEMORY;
+        *len += size;
+    }
+    return ERROR_SUCCESS;
+}
+
+/* Copy the contents of the data chunks into the response buffer. File
+ * contents are read straight into it, without an intermediate buffer. */
+static ULONG copy_body(char *p, const HTTP_DATA_CHUNK *chunks, USHORT count)
+{
+    OVERLAPPED ovl = {};
+    ULONGLONG size;
+    ULONG ret = ERROR_SUCCESS;
+    HANDLE event = NULL;
+    DWORD ret_size;
+    USHORT i;
+
+    for (i = 0; i < count && !ret; ++i)
+    {
+        const HTTP_DATA_CHUNK *chunk = &chunks[i];
+
+        if ((ret = get_chunk_size(chunk, &size)))
+            break;
+
+        if (chunk->DataChunkType == HttpDataChunkFromMemory)
+        {
+            memcpy(p, chunk->FromMemory.pBuffer, size);
+            p += size;
+            continue;
+        }
+
+        if (!event && !(event = CreateEventW(NULL, TRUE, FALSE, NULL)))
+            return GetLastError();
+        ovl.Offset = chunk->FromFileHandle.ByteRange.StartingOffset.LowPart;
+        ovl.OffsetHigh = chunk->FromFileHandle.ByteRange.StartingOffset.HighPart;
+        /* Don't queue a completion packet if the file is bound to a completion port. */
+        ovl.hEvent = (HANDLE)((ULONG_PTR)event | 1);
+        if (!ReadFile(chunk->FromFileHandle.FileHandle, p, size, NULL, &ovl) && GetLastError() != ERROR_IO_PENDING)
+            ret = GetLastError();
+        else if (!GetOverlappedResult(chunk->FromFileHandle.FileHandle, &ovl, &ret_size, TRUE))
+            ret = GetLastError();
+        else if (ret_size != size)
+            ret = ERROR_HANDLE_EOF;
+        p += size;
+    }
+
+    if (event)
+        CloseHandle(event);
+    return ret;
+}
+
 /***********************************************************************
  *        HttpSendHttpResponse     (HTTPAPI.@)
  */
@@ -439,16 +532,9 @@ ULONG WINAPI HttpSendHttpResponse(HANDLE queue, HTTP_REQUEST_ID id, ULONG flags,
     if (log_data)
         WARN("Ignoring log_data.\n");
 
+    if ((ret = get_body_size(response->s.pEntityChunks, response->s.EntityChunkCount, &body_len)))
+        return ret;
     len = 12 + sprintf(dummy, "%hu", response->s.StatusCode) + response->s.ReasonLength;
-    for (i = 0; i < response->s.EntityChunkCount; ++i)
-    {
-        if (response->s.pEntityChunks[i].DataChunkType != HttpDataChunkFromMemory)
-        {
-            FIXME("Unhandled data chunk type %u.\n", response->s.pEntityChunks[i].DataChunkType);
-            return ERROR_CALL_NOT_IMPLEMENTED;
-        }
-        body_len += response->s.pEntityChunks[i].FromMemory.BufferLength;
-    }
     len += body_len;
     for (i = 0; i < HttpHeaderResponseMaximum; ++i)
     {
@@ -498,11 +584,10 @@ ULONG WINAPI HttpSendHttpResponse(HANDLE queue, HTTP_REQUEST_ID id, ULONG flags,
     /* Don't use strcat, because this might be the end of the buffer. */
     memcpy(p, "\r\n", 2);
     p += 2;
-    for (i = 0; i < response->s.EntityChunkCount; ++i)
+    if ((ret = copy_body(p, response->s.pEntityChunks, response->s.EntityChunkCount)))
     {
-        const HTTP_DATA_CHUNK *chunk = &response->s.pEntityChunks[i];
-        memcpy(p, chunk->FromMemory.pBuffer, chunk->FromMemory.BufferLength);
-        p += chunk->FromMemory.BufferLength;
+        free(buffer);
+        return ret;
     }
 
     if (!ovl)
@@ -544,9 +629,7 @@ ULONG WINAPI HttpSendResponseEntityBody(HANDLE queue, HTTP_REQUEST_ID id,
     struct http_response *buffer;
     OVERLAPPED dummy_ovl = {};
     ULONG ret = NO_ERROR;
-    int len = 0;
-    char *p;
-    USHORT i;
+    int len;
 
     TRACE("queue %p, id %s, flags %#lx, entity_chunk_count %u, entity_chunks %p, "
             "ret_size %p, reserved1 %p, reserved2 %#lx, ovl %p, log_data %p\n",
@@ -561,16 +644,8 @@ ULONG WINAPI HttpSendResponseEntityBody(HANDLE queue, HTTP_REQUEST_ID id,
     if (log_data)
         WARN("Ignoring log_data.\n");
 
-    /* Compute the length of the body. */
-    for (i = 0; i < entity_chunk_count; ++i)
-    {
-        if (entity_chunks[i].DataChunkType != HttpDataChunkFromMemory)
-        {
-            FIXME("Unhandled data chunk type %u.\n", entity_chunks[i].DataChunkType);
-            return ERROR_CALL_NOT_IMPLEMENTED;
-        }
-        len += entity_chunks[i].FromMemory.BufferLength;
-    }
+    if ((ret = get_body_size(entity_chunks, entity_chunk_count, &len)))
+        return ret;
 
     if (!(buffer = malloc(offsetof(struct http_response, buffer[len]))))
         return ERROR_OUTOFMEMORY;
@@ -578,12 +653,10 @@ ULONG WINAPI HttpSendResponseEntityBody(HANDLE queue, HTTP_REQUEST_ID id,
     buffer->response_flags = flags;
     buffer->len = len;
 
-    p = buffer->buffer;
-    for (i = 0; i < entity_chunk_count; ++i)
+    if ((ret = copy_body(buffer->buffer, entity_chunks, entity_chunk_count)))
     {
-        const HTTP_DATA_CHUNK *chunk = &entity_chunks[i];
-        memcpy(p, chunk->FromMemory.pBuffer, chunk->FromMemory.BufferLength);
-        p += chunk->FromMemory.BufferLength;
+        free(buffer);
+        return ret;
     }
 
     if (!ovl)
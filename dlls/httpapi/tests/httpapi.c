@@ -1011,6 +1011,74 @@ static void test_v1_entity_body(void)
     ok(ret, "Failed to close queue handle, error %lu.\n", GetLastError());
 }
 
+static void test_v1_file_body(void)
+{
+    char DECLSPEC_ALIGN(8) req_buffer[2048], response_buffer[2048];
+    HTTP_REQUEST_V1 *req = (HTTP_REQUEST_V1 *)req_buffer;
+    char path[MAX_PATH], req_text[200];
+    HTTP_RESPONSE_V1 response = {};
+    HTTP_DATA_CHUNK chunks[2] = {};
+    OVERLAPPED ovl = {};
+    unsigned short port;
+    HANDLE queue, file;
+    DWORD ret_size;
+    int ret;
+    SOCKET s;
+
+    GetTempPathA(ARRAY_SIZE(path), path);
+    strcat(path, "httpapi_body.txt");
+    file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS,
+            FILE_FLAG_OVERLAPPED | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    ok(file != INVALID_HANDLE_VALUE, "Failed to create file, error %lu.\n", GetLastError());
+    ret = WriteFile(file, "pingpongpang", 12, NULL, &ovl);
+    ok(ret || GetLastError() == ERROR_IO_PENDING, "Failed to write file, error %lu.\n", GetLastError());
+    ret = GetOverlappedResult(file, &ovl, &ret_size, TRUE);
+    ok(ret, "Failed to write file, error %lu.\n", GetLastError());
+
+    ret = HttpCreateHttpHandle(&queue, 0);
+    ok(!ret, "Got error %u.\n", ret);
+    port = add_url_v1(queue);
+    s = create_client_socket(port);
+
+    sprintf(req_text, simple_req, port);
+    ret = send(s, req_text, strlen(req_text), 0);
+    ok(ret == strlen(req_text), "send() returned %d.\n", ret);
+    ret = HttpReceiveHttpRequest(queue, HTTP_NULL_ID, 0, (HTTP_REQUEST *)req, sizeof(req_buffer), &ret_size, NULL);
+    ok(!ret, "Got error %u.\n", ret);
+
+    response.StatusCode = 418;
+    response.pReason = "I'm a teapot";
+    response.ReasonLength = 12;
+    response.EntityChunkCount = ARRAY_SIZE(chunks);
+    response.pEntityChunks = chunks;
+    chunks[0].DataChunkType = HttpDataChunkFromFileHandle;
+    chunks[0].FromFileHandle.ByteRange.StartingOffset.QuadPart = 4;
+    chunks[0].FromFileHandle.ByteRange.Length.QuadPart = 4;
+    chunks[0].FromFileHandle.FileHandle = file;
+    chunks[1].DataChunkType = HttpDataChunkFromFileHandle;
+    chunks[1].FromFileHandle.ByteRange.StartingOffset.QuadPart = 8;
+    chunks[1].FromFileHandle.ByteRange.Length.QuadPart = HTTP_BYTE_RANGE_TO_EOF;
+    chunks[1].FromFileHandle.FileHandle = file;
+    ret = HttpSendHttpResponse(queue, req->RequestId, 0, (HTTP_RESPONSE *)&response, NULL, NULL, NULL, 0, NULL, NULL);
+    ok(!ret, "Got error %u.\n", ret);
+
+    memset(response_buffer, 0, sizeof(response_buffer));
+    ret = recv(s, response_buffer, sizeof(response_buffer), 0);
+    ok(ret > 0, "recv() failed.\n");
+    if (winetest_debug > 1)
+        trace("%.*s\n", ret, response_buffer);
+    ok(!strncmp(response_buffer, "HTTP/1.1 418 I'm a teapot\r\n", 27), "Got incorrect status line.\n");
+    ok(!!strstr(response_buffer, "\r\nContent-Length: 8\r\n"), "Missing or malformed Content-Length header.\n");
+    ok(!memcmp(response_buffer + ret - 12, "\r\n\r\npongpang", 12), "Response did not end with entity data.\n");
+
+    ret = remove_url_v1(queue, port);
+    ok(!ret, "Got error %u.\n", ret);
+    closesocket(s);
+    ret = CloseHandle(queue);
+    ok(ret, "Failed to close queue handle, error %lu.\n", GetLastError());
+    CloseHandle(file);
+}
+
 static void test_v1_bad_request(void)
 {
     char response_buffer[2048];
@@ -1877,6 +1945,7 @@ START_TEST(httpapi)
     test_v1_multiple_requests();
     test_v1_short_buffer();
     test_v1_entity_body();
+    test_v1_file_body();
     test_v1_bad_request();
     test_v1_cooked_url();
     test_v1_unknown_tokens();
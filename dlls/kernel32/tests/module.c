@@ -1885,6 +1885,44 @@ static void test_dont_resolve_dll_references(void)
     ok( !!ret, "DeleteFileA returned %lu\n", ret );
 }
 
+static void test_GetProcAddress_exports(void)
+{
+    HMODULE mod = GetModuleHandleA( "kernel32.dll" );
+    const IMAGE_EXPORT_DIRECTORY *exports;
+    const DWORD *names, *functions;
+    const WORD *ordinals;
+    ULONG size;
+    DWORD i;
+    void *proc;
+
+    exports = RtlImageDirectoryEntryToData( mod, TRUE, IMAGE_DIRECTORY_ENTRY_EXPORT, &size );
+    ok( exports != NULL, "no export directory\n" );
+    if (!exports) return;
+
+    names = (const DWORD *)((const char *)mod + exports->AddressOfNames);
+    ordinals = (const WORD *)((const char *)mod + exports->AddressOfNameOrdinals);
+    functions = (const DWORD *)((const char *)mod + exports->AddressOfFunctions);
+
+    /* look up every name twice, the loader may index them after the first lookups */
+    for (i = 0; i < 2 * exports->NumberOfNames; i++)
+    {
+        DWORD pos = i % exports->NumberOfNames;
+        const char *name = (const char *)mod + names[pos];
+        const char *func = (const char *)mod + functions[ordinals[pos]];
+
+        proc = GetProcAddress( mod, name );
+        ok( proc != NULL, "%s not found\n", name );
+        /* skip forwarded exports */
+        if (func >= (const char *)exports && func < (const char *)exports + size) continue;
+        ok( proc == func, "%s: got %p, expected %p\n", name, proc, func );
+    }
+
+    SetLastError( 0xdeadbeef );
+    proc = GetProcAddress( mod, "DoesNotExist" );
+    ok( !proc, "got %p\n", proc );
+    ok( GetLastError() == ERROR_PROC_NOT_FOUND, "got error %lu\n", GetLastError() );
+}
+
 START_TEST(module)
 {
     WCHAR filenameW[MAX_PATH];
@@ -1911,6 +1949,7 @@ START_TEST(module)
     testNestedLoadLibraryA();
     testLoadLibraryA_Wrong();
     testGetProcAddress_Wrong();
+    test_GetProcAddress_exports();
     testLoadLibraryEx();
     test_LoadLibraryEx_search_flags();
     testGetModuleHandleEx();
@@ -2243,6 +2243,38 @@ static void test_write_watch(void)
     if (count) ok( results[0] == base + 5*pagesize, "wrong result %p\n", results[0] );
 
     VirtualFree( base, 0, MEM_RELEASE );
+
+    /* writes to decommitted and recommitted pages are still watched */
+
+    base = VirtualAlloc( 0, size, MEM_RESERVE | MEM_COMMIT | MEM_WRITE_WATCH, PAGE_READWRITE );
+    ok( base != NULL, "VirtualAlloc failed %lu\n", GetLastError() );
+    base[2*pagesize] = 1;
+
+    ret = VirtualFree( base + pagesize, pagesize, MEM_DECOMMIT );
+    ok( ret, "VirtualFree failed %lu\n", GetLastError() );
+    ok( VirtualAlloc( base + pagesize, pagesize, MEM_COMMIT, PAGE_READWRITE ) == base + pagesize,
+        "VirtualAlloc failed %lu\n", GetLastError() );
+
+    base[pagesize] = 1;
+    base[3*pagesize] = 1;
+
+    count = 64;
+    ret = pGetWriteWatch( WRITE_WATCH_FLAG_RESET, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 3, "wrong count %Iu\n", count );
+    ok( results[0] == base + pagesize, "wrong result %p\n", results[0] );
+    ok( results[1] == base + 2*pagesize, "wrong result %p\n", results[1] );
+    ok( results[2] == base + 3*pagesize, "wrong result %p\n", results[2] );
+
+    base[pagesize + 1] = 2;
+
+    count = 64;
+    ret = pGetWriteWatch( 0, base, size, results, &count, &pagesize );
+    ok( !ret, "GetWriteWatch failed %lu\n", GetLastError() );
+    ok( count == 1, "wrong count %Iu\n", count );
+    ok( results[0] == base + pagesize, "wrong result %p\n", results[0] );
+
+    VirtualFree( base, 0, MEM_RELEASE );
 }
 
 #if defined(__i386__) || defined(__x86_64__)
@@ -3661,11 +3661,21 @@ int CDECL _write(int fd, const void* buf, unsigned int count)
         }
         else if (ioinfo_get_textmode(info) == TEXTMODE_ANSI)
         {
-            for (j = 0; i < count && j < sizeof(lfbuf)-1; i++, j++)
+            while (i < count && j < sizeof(lfbuf)-1)
             {
-                if (s[i] == '\n')
+                DWORD len = min(count - i, sizeof(lfbuf)-1 - j);
+                const char *nl = memchr(s + i, '\n', len);
+
+                if (nl) len = nl - (s + i);
+                memcpy(lfbuf + j, s + i, len);
+                i += len;
+                j += len;
+                if (nl)
+                {
                     lfbuf[j++] = '\r';
-                lfbuf[j] = s[i];
+                    lfbuf[j++] = '\n';
+                    i++;
+                }
             }
         }
         else if (ioinfo_get_textmode(info) == TEXTMODE_UTF16LE || console)
@@ -3910,19 +3920,37 @@ char * CDECL fgets(char *s, int size, FILE* file)
 
   _lock_file(file);
 
-  while ((size >1) && (cc = _fgetc_nolock(file)) != EOF && cc != '\n')
-    {
+  while (size > 1)
+  {
+      /* copy as much of the line as possible straight from the stream buffer */
+      if (file->_cnt > 0)
+      {
+          int cnt = min(file->_cnt, size - 1);
+          char *nl = memchr(file->_ptr, '\n', cnt);
+
+          if (nl) cnt = nl - file->_ptr + 1;
+          memcpy(s, file->_ptr, cnt);
+          file->_ptr += cnt;
+          file->_cnt -= cnt;
+          s += cnt;
+          size -= cnt;
+          if (nl) break;
+          continue;
+      }
+
+      if ((cc = _fgetc_nolock(file)) == EOF)
+          break;
       *s++ = (char)cc;
-      size --;
-    }
+      size--;
+      if (cc == '\n')
+          break;
+  }
   if ((cc == EOF) && (s == buf_start)) /* If nothing read, return 0*/
   {
     TRACE(":nothing read\n");
     _unlock_file(file);
     return NULL;
   }
-  if ((cc != EOF) && (size > 1))
-    *s++ = cc;
   *s = '\0';
   TRACE(":got %s\n", debugstr_a(buf_start));
   _unlock_file(file);
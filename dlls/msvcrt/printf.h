@@ -65,11 +65,31 @@ static inline const APICHAR* FUNC_NAME(pf_parse_int)(const APICHAR *fmt, int *va
     return fmt;
 }
 
+/* pf_output_repeat: outputs count copies of ch, a chunk at a time */
+static inline int FUNC_NAME(pf_output_repeat)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx,
+        APICHAR ch, int count)
+{
+    APICHAR buf[32];
+    int i, r, written = 0;
+
+    for(i=0; i<ARRAY_SIZE(buf) && i<count; i++)
+        buf[i] = ch;
+
+    while(count > 0) {
+        r = pf_puts(puts_ctx, count < ARRAY_SIZE(buf) ? count : ARRAY_SIZE(buf), buf);
+        if(r < 0)
+            return r;
+        written += r;
+        count -= ARRAY_SIZE(buf);
+    }
+    return written;
+}
+
 /* pf_fill: takes care of signs, alignment, zero and field padding */
 static inline int FUNC_NAME(pf_fill)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ctx,
         int len, pf_flags *flags, BOOL left)
 {
-    int i, r = 0, written;
+    int r = 0, written;
 
     if(flags->Sign && !strchr("diaAeEfFgG", flags->Format))
         flags->Sign = 0;
@@ -82,7 +102,7 @@ static inline int FUNC_NAME(pf_fill)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ct
     }
     written = r;
 
-    if((!left && flags->LeftAlign) || (left && !flags->LeftAlign)) {
+    if(r>=0 && ((!left && flags->LeftAlign) || (left && !flags->LeftAlign))) {
         APICHAR ch;
 
         if(left && flags->PadZero)
@@ -90,10 +110,9 @@ static inline int FUNC_NAME(pf_fill)(FUNC_NAME(puts_clbk) pf_puts, void *puts_ct
         else
             ch = ' ';
 
-        for(i=0; i<flags->FieldLength-len && r>=0; i++) {
-            r = pf_puts(puts_ctx, 1, &ch);
+        r = FUNC_NAME(pf_output_repeat)(pf_puts, puts_ctx, ch, flags->FieldLength-len);
+        if(r >= 0)
             written += r;
-        }
     }
 
 
@@ -157,18 +176,18 @@ static inline int FUNC_NAME(pf_output_wstr)(FUNC_NAME(puts_clbk) pf_puts, void *
 #ifdef PRINTF_WIDE
     return pf_puts(puts_ctx, len, str);
 #else
-    LPSTR out;
+    char buf[128], *out = buf;
     int len_a = wcstombs_len(NULL, str, len, locale);
     if(len_a < 0)
         return -1;
 
-    out = HeapAlloc(GetProcessHeap(), 0, len_a);
-    if(!out)
+    if(len_a > ARRAY_SIZE(buf) && !(out = HeapAlloc(GetProcessHeap(), 0, len_a)))
         return -1;
 
     wcstombs_len(out, str, len, locale);
     len = pf_puts(puts_ctx, len_a, out);
-    HeapFree(GetProcessHeap(), 0, out);
+    if(out != buf)
+        HeapFree(GetProcessHeap(), 0, out);
     return len;
 #endif
 }
@@ -177,18 +196,18 @@ static inline int FUNC_NAME(pf_output_str)(FUNC_NAME(puts_clbk) pf_puts, void *p
         const char *str, int len, _locale_t locale)
 {
 #ifdef PRINTF_WIDE
-    LPWSTR out;
+    wchar_t buf[64], *out = buf;
     int len_w = mbstowcs_len(NULL, str, len, locale);
     if(len_w < 0)
         return -1;
 
-    out = HeapAlloc(GetProcessHeap(), 0, len_w*sizeof(WCHAR));
-    if(!out)
+    if(len_w > ARRAY_SIZE(buf) && !(out = HeapAlloc(GetProcessHeap(), 0, len_w*sizeof(WCHAR))))
         return -1;
 
     mbstowcs_len(out, str, len, locale);
     len = pf_puts(puts_ctx, len_w, out);
-    HeapFree(GetProcessHeap(), 0, out);
+    if(out != buf)
+        HeapFree(GetProcessHeap(), 0, out);
     return len;
 #else
     return pf_puts(puts_ctx, len, str);
@@ -569,6 +588,14 @@ static inline void FUNC_NAME(pf_integer_conv)(APICHAR *buf, pf_flags *flags, LON
         flags->Alternate = FALSE;
         if(flags->Precision)
             buf[i++] = '0';
+    } else if((ULONGLONG)x <= UINT_MAX) {
+        /* avoid 64-bit divisions when the value fits in 32 bits */
+        unsigned int v = x;
+
+        while(v != 0) {
+            buf[i++] = digits[v%base];
+            v /= base;
+        }
     } else {
         while(x != 0) {
             j = (ULONGLONG)x%base;
@@ -610,7 +637,7 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
     APICHAR buf[LIMB_DIGITS + 1];
     BOOL trim_tail = FALSE, round_up = FALSE;
     pf_flags f;
-    int limb_len, prec;
+    int limb_len, prec, zeros;
     ULONGLONG m;
     DWORD l;
 
@@ -862,11 +889,11 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
             ret += r;
         }
 
-        buf[0] = '0';
-        for(; radix_pos>0; radix_pos--) {
-            r = pf_puts(puts_ctx, 1, buf);
+        if(radix_pos > 0) {
+            r = FUNC_NAME(pf_output_repeat)(pf_puts, puts_ctx, '0', radix_pos);
             if(r < 0) return r;
             ret += r;
+            radix_pos = 0;
         }
 
         if(flags->Precision || flags->Alternate) {
@@ -877,11 +904,14 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
         }
 
         prec = flags->Precision;
-        buf[0] = '0';
-        for(; prec>0 && radix_pos+LIMB_DIGITS-first_limb_len<0; radix_pos++, prec--) {
-            r = pf_puts(puts_ctx, 1, buf);
+        zeros = first_limb_len-LIMB_DIGITS-radix_pos;
+        if(zeros > prec) zeros = prec;
+        if(zeros > 0) {
+            r = FUNC_NAME(pf_output_repeat)(pf_puts, puts_ctx, '0', zeros);
             if(r < 0) return r;
             ret += r;
+            radix_pos += zeros;
+            prec -= zeros;
         }
 
         for(; prec>0 && i>=b->b; i--) {
@@ -903,12 +933,9 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
             ret += r;
         }
 
-        buf[0] = '0';
-        for(; prec>0; prec--) {
-            r = pf_puts(puts_ctx, 1, buf);
-            if(r < 0) return r;
-            ret += r;
-        }
+        r = FUNC_NAME(pf_output_repeat)(pf_puts, puts_ctx, '0', prec);
+        if(r < 0) return r;
+        ret += r;
     } else {
         l = b->data[bnum_idx(b, b->e - 1)];
         l /= p10s[first_limb_len - 1];
@@ -949,12 +976,9 @@ static inline int FUNC_NAME(pf_output_fp)(FUNC_NAME(puts_clbk) pf_puts, void *pu
             ret += r;
         }
 
-        buf[0] = '0';
-        for(; prec>0; prec--) {
-            r = pf_puts(puts_ctx, 1, buf);
-            if(r < 0) return r;
-            ret += r;
-        }
+        r = FUNC_NAME(pf_output_repeat)(pf_puts, puts_ctx, '0', prec);
+        if(r < 0) return r;
+        ret += r;
 
         if(!trim_tail || radix_pos) {
             buf[0] = flags->Format;
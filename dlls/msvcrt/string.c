@@ -33,6 +33,7 @@
 #include "winnls.h"
 #include "wine/asm.h"
 #include "wine/debug.h"
+#include "wine/wordscan.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(msvcrt);
 
@@ -1566,7 +1567,11 @@ int CDECL _atoldbl(_LDOUBLE *value, char *str)
 size_t __cdecl strlen(const char *str)
 {
     const char *s = str;
-    while (*s) s++;
+    const size_t *w;
+
+    for (; !word_is_aligned(s); s++) if (!*s) return s - str;
+    for (w = (const size_t *)s; !word_has_zero_byte(*w); w++) ;
+    for (s = (const char *)w; *s; s++) ;
     return s - str;
 }
 
@@ -3249,11 +3254,17 @@ void *__cdecl memset(void *dst, int c, size_t n)
  */
 char* __cdecl strchr(const char *str, int c)
 {
-    do
+    const size_t mask = word_byte_mask(c);
+    const size_t *w;
+
+    for (; !word_is_aligned(str); str++)
     {
         if (*str == (char)c) return (char*)str;
-    } while (*str++);
-    return NULL;
+        if (!*str) return NULL;
+    }
+    for (w = (const size_t *)str; !word_has_zero_byte(*w) && !word_has_zero_byte(*w ^ mask); w++) ;
+    for (str = (const char *)w; *str != (char)c; str++) if (!*str) return NULL;
+    return (char*)str;
 }
 
 /*********************************************************************
@@ -3271,9 +3282,14 @@ char* __cdecl strrchr(const char *str, int c)
  */
 void* __cdecl memchr(const void *ptr, int c, size_t n)
 {
+    const size_t mask = word_byte_mask(c);
     const unsigned char *p = ptr;
 
-    for (p = ptr; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for (; n && !word_is_aligned(p); n--, p++)
+        if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for (; n >= sizeof(size_t); n -= sizeof(size_t), p += sizeof(size_t))
+        if (word_has_zero_byte(*(const size_t *)p ^ mask)) break;
+    for (; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
     return NULL;
 }
 
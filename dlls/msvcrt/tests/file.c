@@ -640,6 +640,61 @@ static void test_readboundary(void)
   ok(strcmp(buf, rbuf) == 0,"CRLF on buffer boundary failure\n");
   }
 
+/* Test reading and writing text mode lines longer than the stream buffer */
+static void test_long_lines(void)
+{
+  static const int lens[] = { 0, 1, 511, 4095, 4096, 4097, 10000 };
+  FILE *fp;
+  char *buf, *rbuf;
+  int i, j, len;
+
+  buf = malloc(10002);
+  rbuf = malloc(10002);
+
+  fp = fopen("longlines.tst", "wt");
+  ok(fp != NULL, "fopen failed\n");
+  for (i = 0; i < ARRAY_SIZE(lens); i++)
+  {
+    for (j = 0; j < lens[i]; j++)
+      buf[j] = 'a' + (i + j) % 26;
+    buf[j++] = '\n';
+    ok(fwrite(buf, 1, j, fp) == j, "fwrite failed\n");
+  }
+  fclose(fp);
+
+  fp = fopen("longlines.tst", "rb");
+  fseek(fp, 0, SEEK_END);
+  len = ftell(fp);
+  fclose(fp);
+  ok(len == 4095 + 4096 + 4097 + 10000 + 511 + 1 + 2 * ARRAY_SIZE(lens), "file length = %d\n", len);
+
+  fp = fopen("longlines.tst", "rt");
+  for (i = 0; i < ARRAY_SIZE(lens); i++)
+  {
+    for (j = 0; j < lens[i]; j++)
+      buf[j] = 'a' + (i + j) % 26;
+    buf[j++] = '\n';
+    buf[j] = 0;
+
+    /* read longer lines in two parts to test truncation */
+    len = 0;
+    if (lens[i] > 1)
+    {
+      ok(fgets(rbuf, lens[i] / 2 + 1, fp) == rbuf, "fgets failed for line %d\n", i);
+      len = strlen(rbuf);
+      ok(len == lens[i] / 2, "line %d: got length %d\n", i, len);
+    }
+    ok(fgets(rbuf + len, 10002 - len, fp) == rbuf + len, "fgets failed for line %d\n", i);
+    ok(!strcmp(buf, rbuf), "line %d differs\n", i);
+  }
+  ok(fgets(rbuf, 10002, fp) == NULL, "expected EOF\n");
+  fclose(fp);
+  unlink("longlines.tst");
+
+  free(buf);
+  free(rbuf);
+}
+
 static void test_fgetc( void )
 {
   char* tempf;
@@ -3186,6 +3241,7 @@ START_TEST(file)
     test_readmode(FALSE); /* binary mode */
     test_readmode(TRUE);  /* ascii mode */
     test_readboundary();
+    test_long_lines();
     test_fgetc();
     test_fputc();
     test_flsbuf();
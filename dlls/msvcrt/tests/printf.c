@@ -261,6 +261,12 @@ static void test_sprintf( void )
         { "%.13f", "37.8662615745371", 0, DOUBLE_ARG, 0, 0, 37.866261574537077 },
         { "%.14f", "37.86626157453708", 0, DOUBLE_ARG, 0, 0, 37.866261574537077 },
         { "%.15f", "37.866261574537077", 0, DOUBLE_ARG, 0, 0, 37.866261574537077 },
+        { "%40d", "                                      42", 0, INT_ARG, 42 },
+        { "%-40d", "42                                      ", 0, INT_ARG, 42 },
+        { "%040d", "-000000000000000000000000000000000000042", 0, INT_ARG, -42 },
+        { "%.40f", "0.5000000000000000000000000000000000000000", 0, DOUBLE_ARG, 0, 0, 0.5 },
+        { "%.40f", "0.0009765625000000000000000000000000000000", 0, DOUBLE_ARG, 0, 0, 1.0/1024 },
+        { "%45.0f", "                        100000000000000000000", 0, DOUBLE_ARG, 0, 0, 1e20 },
         { "%g", "0.0005", 0, DOUBLE_ARG, 0, 0, 0.0005 },
         { "%g", "5e-005", 0, DOUBLE_ARG, 0, 0, 0.00005 },
         { "%g", "5e-006", 0, DOUBLE_ARG, 0, 0, 0.000005 },
@@ -458,6 +464,7 @@ static void test_snprintf (void)
     char buffer[8];
     const int bufsiz = sizeof buffer;
     unsigned int i;
+    int r;
 
     int (__cdecl *p_snprintf)(char*,size_t,const char*,...) = _snprintf;
 
@@ -472,6 +479,12 @@ static void test_snprintf (void)
         ok (!memcmp (fmt, buffer, valid),
             "\"%s\": rendered \"%.*s\"\n", fmt, valid, buffer);
     }
+
+    /* truncation in the middle of field padding */
+    memset(buffer, 'x', bufsiz);
+    r = p_snprintf(buffer, bufsiz, "%40d", 1);
+    ok (r == -1, "expected -1, returned %d\n", r);
+    ok (!memcmp (buffer, "        ", bufsiz), "rendered \"%.*s\"\n", bufsiz, buffer);
 }
 
 static void test_fprintf(void)
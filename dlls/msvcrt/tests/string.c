@@ -74,7 +74,11 @@ static int (__cdecl *p_wcscpy_s)(wchar_t *wcDest, size_t size, const wchar_t *wc
 static int (__cdecl *p_wcsncpy_s)(wchar_t *wcDest, size_t size, const wchar_t *wcSrc, size_t count);
 static int (__cdecl *p_wcsncat_s)(wchar_t *dst, size_t elem, const wchar_t *src, size_t count);
 static int (__cdecl *p_wcsupr_s)(wchar_t *str, size_t size);
+static size_t (__cdecl *p_strlen)(const char *);
 static size_t (__cdecl *p_strnlen)(const char *, size_t);
+static char* (__cdecl *p_strchr)(const char *, int);
+static void* (__cdecl *p_memchr)(const void *, int, size_t);
+static size_t (__cdecl *p_wcslen)(const wchar_t *);
 static __int64 (__cdecl *p_strtoi64)(const char *, char **, int);
 static unsigned __int64 (__cdecl *p_strtoui64)(const char *, char **, int);
 static __int64 (__cdecl *p_wcstoi64)(const wchar_t *, wchar_t **, int);
@@ -4609,6 +4613,48 @@ static void test_strstr(void)
     }
 }
 
+static void test_string_scan_alignment(void)
+{
+    static char buf[96];
+    static wchar_t wbuf[96];
+    unsigned int i, offset, len;
+    const char *r;
+    size_t ret;
+
+    for (offset = 0; offset < 16; offset++)
+    {
+        for (len = 1; len < 48; len++)
+        {
+            memset(buf, 'a', sizeof(buf));
+            buf[offset + len - 1] = 'b';
+            buf[offset + len] = 0;
+            buf[offset + len + 1] = 'c';
+
+            ret = p_strlen(buf + offset);
+            ok(ret == len, "%u/%u: strlen returned %Iu\n", offset, len, ret);
+            r = p_strchr(buf + offset, 'b');
+            ok(r == buf + offset + len - 1, "%u/%u: strchr returned %p, expected %p\n",
+                    offset, len, r, buf + offset + len - 1);
+            r = p_strchr(buf + offset, 'c');
+            ok(!r, "%u/%u: strchr returned %p\n", offset, len, r);
+            r = p_strchr(buf + offset, 0);
+            ok(r == buf + offset + len, "%u/%u: strchr returned %p, expected %p\n",
+                    offset, len, r, buf + offset + len);
+            r = p_memchr(buf + offset, 'c', len + 2);
+            ok(r == buf + offset + len + 1, "%u/%u: memchr returned %p, expected %p\n",
+                    offset, len, r, buf + offset + len + 1);
+            r = p_memchr(buf + offset, 'c', len + 1);
+            ok(!r, "%u/%u: memchr returned %p\n", offset, len, r);
+
+            for (i = 0; i < ARRAY_SIZE(wbuf); i++) wbuf[i] = 0x100 + 'a';
+            wbuf[offset + len] = 0;
+
+            ret = p_wcslen(wbuf + offset);
+            ok(ret == len, "%u/%u: wcslen returned %Iu\n", offset, len, ret);
+        }
+    }
+}
+
 static void test_iswdigit(void)
 {
     static const struct {
@@ -5041,6 +5087,10 @@ START_TEST(string)
     SET(p_strcpy, "strcpy");
     SET(p_strcmp, "strcmp");
     SET(p_strncmp, "strncmp");
+    SET(p_strlen, "strlen");
+    SET(p_strchr, "strchr");
+    SET(p_memchr, "memchr");
+    SET(p_wcslen, "wcslen");
     pstrcpy_s = (void *)GetProcAddress( hMsvcrt,"strcpy_s" );
     pstrcat_s = (void *)GetProcAddress( hMsvcrt,"strcat_s" );
     p_strncpy_s = (void *)GetProcAddress( hMsvcrt, "strncpy_s" );
@@ -5179,6 +5229,7 @@ START_TEST(string)
     test___strncnt();
     test_C_locale();
     test_strstr();
+    test_string_scan_alignment();
     test_iswdigit();
     test_wcscmp();
     test___STRINGTOLD();
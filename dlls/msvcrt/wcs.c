@@ -30,6 +30,7 @@
 #include "winnls.h"
 #include "wtypes.h"
 #include "wine/debug.h"
+#include "wine/wordscan.h"
 
 WINE_DEFAULT_DEBUG_CHANNEL(msvcrt);
 
@@ -2970,7 +2971,12 @@ wchar_t* CDECL wcsrchr(const wchar_t *str, wchar_t ch)
 size_t CDECL wcslen(const wchar_t *str)
 {
     const wchar_t *s = str;
-    while (*s) s++;
+    const size_t *w;
+
+    /* misaligned strings never reach word alignment and are simply scanned here */
+    for (; !word_is_aligned(s); s++) if (!*s) return s - str;
+    for (w = (const size_t *)s; !word_has_zero_wchar(*w); w++) ;
+    for (s = (const wchar_t *)w; *s; s++) ;
     return s - str;
 }
 
@@ -43,6 +43,7 @@ WINE_DECLARE_DEBUG_CHANNEL(relay);
 WINE_DECLARE_DEBUG_CHANNEL(snoop);
 WINE_DECLARE_DEBUG_CHANNEL(loaddll);
 WINE_DECLARE_DEBUG_CHANNEL(imports);
+WINE_DECLARE_DEBUG_CHANNEL(startup);
 
 #ifdef _WIN64
 #define DEFAULT_SECURITY_COOKIE_64  (((ULONGLONG)0x00002b99 << 32) | 0x2ddfa232)
@@ -131,6 +132,18 @@ struct file_id
 #define HASH_MAP_SIZE 32
 static LIST_ENTRY hash_table[HASH_MAP_SIZE];
 
+/* hash index of the export names of a module, only built for modules with
+ * enough names that binary searches become expensive */
+#define EXPORT_INDEX_MIN_NAMES 256
+
+struct export_index
+{
+    DWORD names;      /* AddressOfNames the index was built for */
+    DWORD count;      /* NumberOfNames the index was built for */
+    DWORD mask;       /* size of the table - 1 */
+    DWORD table[1];   /* name position + 1, or 0 for empty entries */
+};
+
 /* internal representation of loaded modules */
 typedef struct _wine_modref
 {
@@ -138,6 +151,8 @@ typedef struct _wine_modref
     struct file_id        id;
     ULONG                 CheckSum;
     BOOL                  system;
+    ULONG                 export_lookups;
+    struct export_index  *export_index;
 } WINE_MODREF;
 
 static UINT tls_module_count = 32;     /* number of modules with TLS directory */
@@ -1058,6 +1073,84 @@ static int find_name_in_exports( HMODULE module, const IMAGE_EXPORT_DIRECTORY *e
 }
 
 
+/*************************************************************************
+ *		hash_export_name
+ */
+static DWORD hash_export_name( const char *name )
+{
+    DWORD hash = 0x811c9dc5;
+    while (*name) hash = (hash ^ (unsigned char)*name++) * 0x01000193;
+    return hash;
+}
+
+
+/*************************************************************************
+ *		build_export_index
+ *
+ * Build the hash index of the export names of a module.
+ * The loader_section must be locked while calling this function.
+ */
+static struct export_index *build_export_index( WINE_MODREF *wm, const IMAGE_EXPORT_DIRECTORY *exports )
+{
+    const DWORD *names = get_rva( wm->ldr.DllBase, exports->AddressOfNames );
+    struct export_index *index;
+    DWORD i, pos, size = 64;
+
+    while (size < 2 * exports->NumberOfNames) size *= 2;
+    if (!(index = RtlAllocateHeap( GetProcessHeap(), HEAP_ZERO_MEMORY,
+                                   offsetof( struct export_index, table[size] ) )))
+        return NULL;
+    index->names = exports->AddressOfNames;
+    index->count = exports->NumberOfNames;
+    index->mask  = size - 1;
+
+    for (pos = 0; pos < exports->NumberOfNames; pos++)
+    {
+        i = hash_export_name( get_rva( wm->ldr.DllBase, names[pos] )) & index->mask;
+        while (index->table[i]) i = (i + 1) & index->mask;
+        index->table[i] = pos + 1;
+    }
+
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_index );
+    return wm->export_index = index;
+}
+
+
+/*************************************************************************
+ *		find_name_in_export_index
+ *
+ * Helper for find_named_export, returns -1 if the name isn't found in the
+ * export index, or if the module doesn't have one.
+ * The loader_section must be locked while calling this function.
+ */
+static int find_name_in_export_index( HMODULE module, const IMAGE_EXPORT_DIRECTORY *exports, const char *name )
+{
+    const WORD *ordinals = get_rva( module, exports->AddressOfNameOrdinals );
+    const DWORD *names = get_rva( module, exports->AddressOfNames );
+    struct export_index *index;
+    WINE_MODREF *wm;
+    DWORD i;
+
+    if (exports->NumberOfNames < EXPORT_INDEX_MIN_NAMES) return -1;
+    if (!(wm = get_modref( module ))) return -1;
+    if (!(index = wm->export_index) || index->names != exports->AddressOfNames ||
+        index->count != exports->NumberOfNames)
+    {
+        /* building the index hashes every name once, only do it when it's going
+         * to be cheaper than binary searches for the lookups we have seen so far */
+        if (++wm->export_lookups < exports->NumberOfNames / 8) return -1;
+        if (!(index = build_export_index( wm, exports ))) return -1;
+    }
+
+    for (i = hash_export_name( name ) & index->mask; index->table[i]; i = (i + 1) & index->mask)
+    {
+        DWORD pos = index->table[i] - 1;
+        if (!strcmp( get_rva( module, names[pos] ), name )) return ordinals[pos];
+    }
+    return -1;
+}
+
+
 /*************************************************************************
  *		find_named_export
  *
@@ -1080,8 +1173,10 @@ static FARPROC find_named_export( HMODULE module, const IMAGE_EXPORT_DIRECTORY *
             return find_ordinal_export( module, exports, exp_size, ordinals[hint], load_path, importer, is_dynamic );
     }
 
-    /* then do a binary search */
-    if ((ordinal = find_name_in_exports( module, exports, name )) == -1) return NULL;
+    /* then check the export index, falling back to a binary search */
+    if ((ordinal = find_name_in_export_index( module, exports, name )) == -1)
+        ordinal = find_name_in_exports( module, exports, name );
+    if (ordinal == -1) return NULL;
     return find_ordinal_export( module, exports, exp_size, ordinal, load_path, importer, is_dynamic );
 
 }
@@ -1457,6 +1552,21 @@ static NTSTATUS fixup_imports_ilonly( WINE_MODREF *wm, LPCWSTR load_path, void *
 }
 
 
+/*************************************************************************
+ *		startup_time
+ *
+ * Return a timestamp in microseconds for the startup traces.
+ */
+static ULONGLONG startup_time(void)
+{
+    LARGE_INTEGER counter, freq;
+
+    NtQueryPerformanceCounter( &counter, &freq );
+    return counter.QuadPart / freq.QuadPart * 1000000 +
+           counter.QuadPart % freq.QuadPart * 1000000 / freq.QuadPart;
+}
+
+
 /****************************************************************
  *       fixup_imports
  *
@@ -1472,6 +1582,7 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
     DWORD size;
     NTSTATUS status;
     ULONG_PTR cookie;
+    ULONGLONG start = 0;
 
     if (!(wm->ldr.Flags & LDR_DONT_RESOLVE_REFS)) return STATUS_SUCCESS;  /* already done */
     wm->ldr.Flags &= ~LDR_DONT_RESOLVE_REFS;
@@ -1487,6 +1598,8 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
 
     if (!nb_imports) return STATUS_SUCCESS;  /* no imports */
 
+    if (TRACE_ON(startup)) start = startup_time();
+
     if (!create_module_activation_context( &wm->ldr ))
         RtlActivateActivationContext( 0, wm->ldr.ActivationContext, &cookie );
 
@@ -1503,6 +1616,9 @@ static NTSTATUS fixup_imports( WINE_MODREF *wm, LPCWSTR load_path )
             add_module_dependency_after( wm->ldr.DdagNode, imp->ldr.DdagNode, dep_after );
     }
     if (wm->ldr.ActivationContext) RtlDeactivateActivationContext( 0, cookie );
+
+    TRACE_(startup)( "%s: resolved %u imports in %s us\n", debugstr_w(wm->ldr.BaseDllName.Buffer),
+                     nb_imports, wine_dbgstr_longlong( startup_time() - start ));
     return status;
 }
 
@@ -1754,6 +1870,7 @@ static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved )
     LDR_DATA_TABLE_ENTRY *mod;
     ULONG_PTR cookie;
     WINE_MODREF *wm;
+    ULONGLONG start;
 
     if (process_detaching) return status;
 
@@ -1787,7 +1904,10 @@ static NTSTATUS process_attach( LDR_DDAG_NODE *node, LPVOID lpReserved )
     if (status == STATUS_SUCCESS)
     {
         call_ldr_notifications( LDR_DLL_NOTIFICATION_REASON_LOADED, &wm->ldr );
+        start = TRACE_ON(startup) ? startup_time() : 0;
         status = MODULE_InitDLL( wm, DLL_PROCESS_ATTACH, lpReserved );
+        TRACE_(startup)( "%s: process attach took %s us\n", debugstr_w(wm->ldr.BaseDllName.Buffer),
+                         wine_dbgstr_longlong( startup_time() - start ));
         if (status == STATUS_SUCCESS)
         {
             wm->ldr.Flags |= LDR_PROCESS_ATTACHED;
@@ -3992,6 +4112,7 @@ static void free_modref( WINE_MODREF *wm )
     NtUnmapViewOfSection( NtCurrentProcess(), wm->ldr.DllBase );
     if (cached_modref == wm) cached_modref = NULL;
     RtlFreeUnicodeString( &wm->ldr.FullDllName );
+    RtlFreeHeap( GetProcessHeap(), 0, wm->export_index );
     RtlFreeHeap( GetProcessHeap(), 0, wm );
 }
 
@@ -4370,6 +4491,7 @@ void loader_init( CONTEXT *context, void **entry )
     NTSTATUS status;
     ULONG_PTR cookie, port = 0;
     WINE_MODREF *wm;
+    ULONGLONG start = 0;
 
     if (process_detaching) NtTerminateThread( GetCurrentThread(), 0 );
 
@@ -4382,6 +4504,8 @@ void loader_init( CONTEXT *context, void **entry )
         PEB *peb = NtCurrentTeb()->Peb;
         unsigned int i;
 
+        if (TRACE_ON(startup)) start = startup_time();
+
         peb->LdrData            = &ldr;
         peb->FastPebLock        = &peb_lock;
         peb->TlsBitmap          = &tls_bitmap;
@@ -4445,6 +4569,9 @@ void loader_init( CONTEXT *context, void **entry )
             NtTerminateProcess( GetCurrentProcess(), status );
         }
         imports_fixup_done = TRUE;
+        TRACE_(startup)( "%s: imports resolved after %s us\n",
+                         debugstr_w(peb->ProcessParameters->ImagePathName.Buffer),
+                         wine_dbgstr_longlong( startup_time() - start ));
     }
     else
     {
@@ -4495,6 +4622,10 @@ void loader_init( CONTEXT *context, void **entry )
 
         NtQueryInformationProcess( GetCurrentProcess(), ProcessDebugPort, &port, sizeof(port), NULL );
         if (port) process_breakpoint();
+
+        if (start) TRACE_(startup)( "%s: dlls initialized after %s us\n",
+                                    debugstr_w(NtCurrentTeb()->Peb->ProcessParameters->ImagePathName.Buffer),
+                                    wine_dbgstr_longlong( startup_time() - start ));
     }
     else
     {
@@ -33,6 +33,7 @@
 #include "winnls.h"
 #include "winternl.h"
 #include "ntdll_misc.h"
+#include "wine/wordscan.h"
 
 
 /* same as wctypes except for TAB, which doesn't have C1_BLANK for some reason... */
@@ -72,9 +73,14 @@ static const unsigned short ctypes[257] =
  */
 void * __cdecl memchr( const void *ptr, int c, size_t n )
 {
+    const size_t mask = word_byte_mask( c );
     const unsigned char *p = ptr;
 
-    for (p = ptr; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for ( ; n && !word_is_aligned( p ); n--, p++)
+        if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
+    for ( ; n >= sizeof(size_t); n -= sizeof(size_t), p += sizeof(size_t))
+        if (word_has_zero_byte( *(const size_t *)p ^ mask )) break;
+    for ( ; n; n--, p++) if (*p == (unsigned char)c) return (void *)(ULONG_PTR)p;
     return NULL;
 }
 
@@ -358,8 +364,17 @@ errno_t __cdecl strcat_s( char *dst, size_t len, const char *src )
  */
 char * __cdecl strchr( const char *str, int c )
 {
-    do { if (*str == (char)c) return (char *)(ULONG_PTR)str; } while (*str++);
-    return NULL;
+    const size_t mask = word_byte_mask( c );
+    const size_t *w;
+
+    for ( ; !word_is_aligned( str ); str++)
+    {
+        if (*str == (char)c) return (char *)(ULONG_PTR)str;
+        if (!*str) return NULL;
+    }
+    for (w = (const size_t *)str; !word_has_zero_byte( *w ) && !word_has_zero_byte( *w ^ mask ); w++) ;
+    for (str = (const char *)w; *str != (char)c; str++) if (!*str) return NULL;
+    return (char *)(ULONG_PTR)str;
 }
 
 
@@ -423,7 +438,11 @@ size_t __cdecl strcspn( const char *str, const char *reject )
 size_t __cdecl strlen( const char *str )
 {
     const char *s = str;
-    while (*s) s++;
+    const size_t *w;
+
+    for ( ; !word_is_aligned( s ); s++) if (!*s) return s - str;
+    for (w = (const size_t *)s; !word_has_zero_byte( *w ); w++) ;
+    for (s = (const char *)w; *s; s++) ;
     return s - str;
 }
 
@@ -1199,6 +1199,29 @@ static void read_pipe_test(ULONG pipe_flags, ULONG pipe_type)
     SleepEx( 1, TRUE ); /* alertable sleep */
     ok( apc_count == 1, "apc not called\n" );
 
+    /* read with a buffer larger than the available data */
+    ret = WriteFile( write, "abc", 3, &written, NULL );
+    ok(ret && written == 3, "WriteFile error %ld\n", GetLastError());
+    ret = WriteFile( write, "de", 2, &written, NULL );
+    ok(ret && written == 2, "WriteFile error %ld\n", GetLastError());
+    memset( buffer, 0, sizeof(buffer) );
+    status = NtReadFile( read, NULL, NULL, NULL, &iosb, buffer, sizeof(buffer), NULL, NULL );
+    ok( status == STATUS_SUCCESS, "wrong status %lx\n", status );
+    if (pipe_type & PIPE_READMODE_MESSAGE)
+    {
+        ok( iosb.Information == 3, "wrong info %Iu\n", iosb.Information );
+        ok( !memcmp( buffer, "abc", 3 ), "wrong data %s\n", debugstr_an( buffer, iosb.Information ) );
+        status = NtReadFile( read, NULL, NULL, NULL, &iosb, buffer, sizeof(buffer), NULL, NULL );
+        ok( status == STATUS_SUCCESS, "wrong status %lx\n", status );
+        ok( iosb.Information == 2, "wrong info %Iu\n", iosb.Information );
+        ok( !memcmp( buffer, "de", 2 ), "wrong data %s\n", debugstr_an( buffer, iosb.Information ) );
+    }
+    else
+    {
+        ok( iosb.Information == 5, "wrong info %Iu\n", iosb.Information );
+        ok( !memcmp( buffer, "abcde", 5 ), "wrong data %s\n", debugstr_an( buffer, iosb.Information ) );
+    }
+
     /* try read with no data */
     apc_count = 0;
     iosb.Status = 0xdeadbabe;
@@ -72,6 +72,9 @@ static int      (__cdecl *p_wcsnicmp)(LPCWSTR,LPCWSTR,int);
 static LPWSTR   (__cdecl *pwcschr)(LPCWSTR, WCHAR);
 static LPWSTR   (__cdecl *pwcsrchr)(LPCWSTR, WCHAR);
 static void*    (__cdecl *pmemchr)(const void*, int, size_t);
+static char*    (__cdecl *pstrchr)(const char*, int);
+static size_t   (__cdecl *pstrlen)(const char*);
+static size_t   (__cdecl *pwcslen)(LPCWSTR);
 
 static void     (__cdecl *pqsort)(void *,size_t,size_t, int(__cdecl *compar)(const void *, const void *) );
 static void*    (__cdecl *pbsearch)(void *,void*,size_t,size_t, int(__cdecl *compar)(const void *, const void *) );
@@ -142,6 +145,9 @@ static void InitFunctionPtrs(void)
     X(wcschr);
     X(wcsrchr);
     X(memchr);
+    X(strchr);
+    X(strlen);
+    X(wcslen);
     X(qsort);
     X(bsearch);
     X(_snprintf);
@@ -2233,6 +2239,48 @@ static void test_memchr(void)
     ok(r == s, "memchr returned %p, expected %p\n", r, s);
 }
 
+static void test_string_scan_alignment(void)
+{
+    static char buf[96];
+    static WCHAR wbuf[96];
+    unsigned int i, offset, len;
+    const char *r;
+    size_t ret;
+
+    for (offset = 0; offset < 16; offset++)
+    {
+        for (len = 1; len < 48; len++)
+        {
+            memset( buf, 'a', sizeof(buf) );
+            buf[offset + len - 1] = 'b';
+            buf[offset + len] = 0;
+            buf[offset + len + 1] = 'c';
+
+            ret = pstrlen( buf + offset );
+            ok( ret == len, "%u/%u: strlen returned %Iu\n", offset, len, ret );
+            r = pstrchr( buf + offset, 'b' );
+            ok( r == buf + offset + len - 1, "%u/%u: strchr returned %p, expected %p\n",
+                offset, len, r, buf + offset + len - 1 );
+            r = pstrchr( buf + offset, 'c' );
+            ok( !r, "%u/%u: strchr returned %p\n", offset, len, r );
+            r = pstrchr( buf + offset, 0 );
+            ok( r == buf + offset + len, "%u/%u: strchr returned %p, expected %p\n",
+                offset, len, r, buf + offset + len );
+            r = pmemchr( buf + offset, 'c', len + 2 );
+            ok( r == buf + offset + len + 1, "%u/%u: memchr returned %p, expected %p\n",
+                offset, len, r, buf + offset + len + 1 );
+            r = pmemchr( buf + offset, 'c', len + 1 );
+            ok( !r, "%u/%u: memchr returned %p\n", offset, len, r );
+
+            for (i = 0; i < ARRAY_SIZE(wbuf); i++) wbuf[i] = 0x100 + 'a';
+            wbuf[offset + len] = 0;
+
+            ret = pwcslen( wbuf + offset );
+            ok( ret == len, "%u/%u: wcslen returned %Iu\n", offset, len, ret );
+        }
+    }
+}
+
 START_TEST(string)
 {
     InitFunctionPtrs();
@@ -2266,4 +2314,5 @@ START_TEST(string)
     test_wctype();
     test_ctype();
     test_memchr();
+    test_string_scan_alignment();
 }
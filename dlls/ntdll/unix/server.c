@@ -246,9 +246,39 @@ static void read_reply_data( void *buffer, size_t size )
  */
 static inline unsigned int wait_reply( struct __server_request_info *req )
 {
-    read_reply_data( &req->u.reply, sizeof(req->u.reply) );
-    if (req->u.reply.reply_header.reply_size)
-        read_reply_data( req->reply_data, req->u.reply.reply_header.reply_size );
+    data_size_t max_size = req->u.req.request_header.reply_size;
+    struct iovec vec[2];
+    size_t size;
+    int ret;
+
+    if (!max_size)
+    {
+        read_reply_data( &req->u.reply, sizeof(req->u.reply) );
+        return req->u.reply.reply_header.error;
+    }
+
+    /* the server writes the reply header and data together, try to read them at once */
+    vec[0].iov_base = &req->u.reply;
+    vec[0].iov_len  = sizeof(req->u.reply);
+    vec[1].iov_base = req->reply_data;
+    vec[1].iov_len  = max_size;
+    while ((ret = readv( ntdll_get_thread_data()->reply_fd, vec, 2 )) < 0)
+    {
+        if (errno == EINTR) continue;
+        if (errno == EPIPE) break;
+        server_protocol_perror("read");
+    }
+    if (ret <= 0) abort_thread(0);  /* the server closed the connection */
+
+    if ((size = ret) < sizeof(req->u.reply))
+    {
+        read_reply_data( (char *)&req->u.reply + size, sizeof(req->u.reply) - size );
+        size = 0;
+    }
+    else size -= sizeof(req->u.reply);
+
+    if (req->u.reply.reply_header.reply_size > size)
+        read_reply_data( (char *)req->reply_data + size, req->u.reply.reply_header.reply_size - size );
     return req->u.reply.reply_header.error;
 }
 
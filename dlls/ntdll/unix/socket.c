@@ -42,6 +42,9 @@
 #ifdef HAVE_NETINET_TCP_H
 # include <netinet/tcp.h>
 #endif
+#ifdef HAVE_NETINET_UDP_H
+# include <netinet/udp.h>
+#endif
 
 #ifdef HAVE_NETIPX_IPX_H
 # include <netipx/ipx.h>
@@ -118,6 +121,9 @@ struct async_recv_ioctl
     int unix_flags;
     unsigned int count;
     BOOL icmp_over_dgram;
+    BOOL udp;
+    unsigned int batch_status;  /* status of a receive done in a batch, or STATUS_PENDING */
+    ULONG_PTR batch_size;
     struct iovec iov[1];
 };
 
@@ -131,6 +137,7 @@ struct async_send_ioctl
     unsigned int count;
     unsigned int iov_cursor;
     int fd;
+    unsigned int batch_status;  /* status of a send done in a batch, or STATUS_PENDING */
     struct iovec iov[1];
 };
 
@@ -709,41 +716,29 @@ static ssize_t fixup_icmp_over_dgram( struct msghdr *hdr, union unix_sockaddr *u
     return recv_len;
 }
 
-static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *size )
+static void init_recv_msghdr( struct async_recv_ioctl *async, struct msghdr *hdr, union unix_sockaddr *unix_addr,
+                              char *control_buffer, size_t control_size )
 {
-    char control_buffer[512];
-    union unix_sockaddr unix_addr;
-    struct msghdr hdr;
-    NTSTATUS status;
-    ssize_t ret;
-
-    memset( &hdr, 0, sizeof(hdr) );
+    memset( hdr, 0, sizeof(*hdr) );
     if (async->addr || async->icmp_over_dgram)
     {
-        hdr.msg_name = &unix_addr.addr;
-        hdr.msg_namelen = sizeof(unix_addr);
+        hdr->msg_name = &unix_addr->addr;
+        hdr->msg_namelen = sizeof(*unix_addr);
     }
-    hdr.msg_iov = async->iov;
-    hdr.msg_iovlen = async->count;
-    hdr.msg_control = control_buffer;
-    hdr.msg_controllen = sizeof(control_buffer);
-
-    while ((ret = virtual_locked_recvmsg( fd, &hdr, async->unix_flags )) < 0 && errno == EINTR);
-
-    if (ret < 0)
-    {
-        /* Unix-like systems return EINVAL when attempting to read OOB data from
-         * an empty socket buffer; Windows returns WSAEWOULDBLOCK. */
-        if ((async->unix_flags & MSG_OOB) && errno == EINVAL)
-            errno = EWOULDBLOCK;
+    hdr->msg_iov = async->iov;
+    hdr->msg_iovlen = async->count;
+    hdr->msg_control = control_buffer;
+    hdr->msg_controllen = control_size;
+}
 
-        if (errno != EWOULDBLOCK) WARN( "recvmsg: %s\n", strerror( errno ) );
-        return sock_errno_to_status( errno );
-    }
+static NTSTATUS finish_recv( struct async_recv_ioctl *async, struct msghdr *hdr, union unix_sockaddr *unix_addr,
+                             ssize_t ret, ULONG_PTR *size )
+{
+    NTSTATUS status;
 
-    status = (hdr.msg_flags & MSG_TRUNC) ? STATUS_BUFFER_OVERFLOW : STATUS_SUCCESS;
+    status = (hdr->msg_flags & MSG_TRUNC) ? STATUS_BUFFER_OVERFLOW : STATUS_SUCCESS;
     if (async->icmp_over_dgram)
-        ret = fixup_icmp_over_dgram( &hdr, &unix_addr, async->io.handle, ret, &status );
+        ret = fixup_icmp_over_dgram( hdr, unix_addr, async->io.handle, ret, &status );
 
     if (async->control)
     {
@@ -757,7 +752,7 @@ static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *siz
 
             wsabuf.len = sizeof(control_buffer64);
             wsabuf.buf = control_buffer64;
-            if (convert_control_headers( &hdr, &wsabuf ))
+            if (convert_control_headers( hdr, &wsabuf ))
             {
                 if (!wow64_translate_control( &wsabuf, async->control ))
                 {
@@ -775,7 +770,7 @@ static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *siz
         }
         else
         {
-            if (!convert_control_headers( &hdr, async->control ))
+            if (!convert_control_headers( hdr, async->control ))
             {
                 WARN( "Application passed insufficient room for control headers.\n" );
                 *async->ret_flags |= WS_MSG_CTRUNC;
@@ -790,13 +785,94 @@ static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *siz
      * MSDN says that the address is ignored for connection-oriented sockets, so
      * don't try to translate it.
      */
-    if (async->addr && hdr.msg_namelen)
-        *async->addr_len = sockaddr_from_unix( &unix_addr, async->addr, *async->addr_len );
+    if (async->addr && hdr->msg_namelen)
+        *async->addr_len = sockaddr_from_unix( unix_addr, async->addr, *async->addr_len );
 
     *size = ret;
     return status;
 }
 
+static NTSTATUS try_recv( int fd, struct async_recv_ioctl *async, ULONG_PTR *size )
+{
+    char control_buffer[512];
+    union unix_sockaddr unix_addr;
+    struct msghdr hdr;
+    ssize_t ret;
+
+    init_recv_msghdr( async, &hdr, &unix_addr, control_buffer, sizeof(control_buffer) );
+
+    while ((ret = virtual_locked_recvmsg( fd, &hdr, async->unix_flags )) < 0 && errno == EINTR);
+
+    if (ret < 0)
+    {
+        /* Unix-like systems return EINVAL when attempting to read OOB data from
+         * an empty socket buffer; Windows returns WSAEWOULDBLOCK. */
+        if ((async->unix_flags & MSG_OOB) && errno == EINVAL)
+            errno = EWOULDBLOCK;
+
+        if (errno != EWOULDBLOCK) WARN( "recvmsg: %s\n", strerror( errno ) );
+        return sock_errno_to_status( errno );
+    }
+
+    return finish_recv( async, &hdr, &unix_addr, ret, size );
+}
+
+static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status );
+
+#ifdef HAVE_RECVMMSG
+
+#define RECV_BATCH_SIZE 8
+
+/* Receive the datagrams that are already waiting for the asyncs queued after
+ * an alerted one, with a single recvmmsg(). The server alerts these asyncs,
+ * and they report the stored result when their own alert gets delivered. */
+static void recv_batch( int fd, struct async_recv_ioctl *async )
+{
+    char control_buffers[RECV_BATCH_SIZE][512];
+    union unix_sockaddr unix_addrs[RECV_BATCH_SIZE];
+    struct async_recv_ioctl *asyncs[RECV_BATCH_SIZE];
+    struct mmsghdr msgs[RECV_BATCH_SIZE];
+    client_ptr_t users[RECV_BATCH_SIZE];
+    unsigned int i, count = 0;
+    int avail, ret;
+
+    if (ioctl( fd, FIONREAD, &avail ) || avail <= 0) return;
+
+    SERVER_START_REQ( socket_alert_batch )
+    {
+        req->handle = wine_server_obj_handle( async->io.handle );
+        req->user   = wine_server_client_ptr( async );
+        req->write  = 0;
+        wine_server_set_reply( req, users, sizeof(users) );
+        if (!wine_server_call( req )) count = wine_server_reply_size( reply ) / sizeof(users[0]);
+    }
+    SERVER_END_REQ;
+
+    /* the asyncs after one that can't be batched receive their data by themselves */
+    for (i = 0; i < count; i++)
+    {
+        asyncs[i] = wine_server_get_ptr( users[i] );
+        if (asyncs[i]->io.callback != async_recv_proc || asyncs[i]->unix_flags || asyncs[i]->icmp_over_dgram)
+            break;
+        init_recv_msghdr( asyncs[i], &msgs[i].msg_hdr, &unix_addrs[i], control_buffers[i], sizeof(control_buffers[i]) );
+    }
+    if (!(count = i)) return;
+
+    while ((ret = virtual_locked_recvmmsg( fd, msgs, count, 0 )) < 0 && errno == EINTR);
+    if (ret < 0)
+    {
+        if (errno != EWOULDBLOCK) WARN( "recvmmsg: %s\n", strerror( errno ) );
+        return;
+    }
+    TRACE( "received %d datagrams for %u asyncs\n", ret, count );
+
+    for (i = 0; i < ret; i++)
+        asyncs[i]->batch_status = finish_recv( asyncs[i], &msgs[i].msg_hdr, &unix_addrs[i],
+                                               msgs[i].msg_len, &asyncs[i]->batch_size );
+}
+
+#endif
+
 static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status )
 {
     struct async_recv_ioctl *async = user;
@@ -804,13 +880,22 @@ static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status )
 
     TRACE( "%#x\n", *status );
 
-    if (*status == STATUS_ALERTED)
+    if (*status == STATUS_ALERTED && async->batch_status != STATUS_PENDING)
+    {
+        /* the data has already been received along with another async */
+        *status = async->batch_status;
+        *info = async->batch_size;
+    }
+    else if (*status == STATUS_ALERTED)
     {
         if ((*status = server_get_unix_fd( async->io.handle, 0, &fd, &needs_close, NULL, NULL )))
             return TRUE;
 
         *status = try_recv( fd, async, info );
         TRACE( "got status %#x, %#lx bytes read\n", *status, *info );
+#ifdef HAVE_RECVMMSG
+        if (!*status && async->udp && !async->unix_flags) recv_batch( fd, async );
+#endif
         if (needs_close) close( fd );
 
         if (*status == STATUS_DEVICE_NOT_READY)
@@ -820,23 +905,31 @@ static BOOL async_recv_proc( void *user, ULONG_PTR *info, unsigned int *status )
     return TRUE;
 }
 
-static BOOL is_icmp_over_dgram( int fd )
+/* return IPPROTO_UDP or IPPROTO_ICMP for the datagram sockets we handle specially */
+static int get_dgram_protocol( int fd )
 {
 #ifdef linux
     socklen_t len;
-    int val;
+    int val, protocol;
 
-    len = sizeof(val);
-    if (getsockopt( fd, SOL_SOCKET, SO_PROTOCOL, (char *)&val, &len ) || val != IPPROTO_ICMP)
-        return FALSE;
+    len = sizeof(protocol);
+    if (getsockopt( fd, SOL_SOCKET, SO_PROTOCOL, (char *)&protocol, &len )) return 0;
+    if (protocol == IPPROTO_UDP) return protocol;
+    if (protocol != IPPROTO_ICMP) return 0;
 
     len = sizeof(val);
-    return !getsockopt( fd, SOL_SOCKET, SO_TYPE, (char *)&val, &len ) && val == SOCK_DGRAM;
+    if (getsockopt( fd, SOL_SOCKET, SO_TYPE, (char *)&val, &len ) || val != SOCK_DGRAM) return 0;
+    return protocol;
 #else
-    return FALSE;
+    return 0;
 #endif
 }
 
+static BOOL is_icmp_over_dgram( int fd )
+{
+    return get_dgram_protocol( fd ) == IPPROTO_ICMP;
+}
+
 static NTSTATUS sock_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc_user, IO_STATUS_BLOCK *io,
                            int fd, struct async_recv_ioctl *async, int force_async )
 {
@@ -894,6 +987,7 @@ static NTSTATUS sock_ioctl_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
     struct async_recv_ioctl *async;
     DWORD async_size;
     unsigned int i;
+    int protocol;
 
     if (unix_flags & MSG_OOB)
     {
@@ -934,7 +1028,10 @@ static NTSTATUS sock_ioctl_recv( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
     async->addr = addr;
     async->addr_len = addr_len;
     async->ret_flags = ret_flags;
-    async->icmp_over_dgram = is_icmp_over_dgram( fd );
+    protocol = get_dgram_protocol( fd );
+    async->icmp_over_dgram = protocol == IPPROTO_ICMP;
+    async->udp = protocol == IPPROTO_UDP;
+    async->batch_status = STATUS_PENDING;
 
     return sock_recv( handle, event, apc, apc_user, io, fd, async, force_async );
 }
@@ -945,6 +1042,7 @@ NTSTATUS sock_read( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE apc,
 {
     static const DWORD async_size = offsetof( struct async_recv_ioctl, iov[1] );
     struct async_recv_ioctl *async;
+    int protocol;
 
     if (!(async = (struct async_recv_ioctl *)alloc_fileio( async_size, async_recv_proc, handle )))
         return STATUS_NO_MEMORY;
@@ -957,40 +1055,44 @@ NTSTATUS sock_read( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE apc,
     async->addr = NULL;
     async->addr_len = NULL;
     async->ret_flags = NULL;
-    async->icmp_over_dgram = is_icmp_over_dgram( fd );
+    protocol = get_dgram_protocol( fd );
+    async->icmp_over_dgram = protocol == IPPROTO_ICMP;
+    async->udp = protocol == IPPROTO_UDP;
+    async->batch_status = STATUS_PENDING;
 
     return sock_recv( handle, event, apc, apc_user, io, fd, async, 1 );
 }
 
 
-static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
+static int get_fd_sock_type( int fd )
 {
-    union unix_sockaddr unix_addr;
-    struct msghdr hdr;
-    int attempt = 0;
-    int sock_type;
+    int sock_type = 0;
     socklen_t len = sizeof(sock_type);
-    ssize_t ret;
 
     getsockopt(fd, SOL_SOCKET, SO_TYPE, &sock_type, &len);
+    return sock_type;
+}
 
-    memset( &hdr, 0, sizeof(hdr) );
+static NTSTATUS init_send_msghdr( int fd, int sock_type, struct async_send_ioctl *async, struct msghdr *hdr,
+                                  union unix_sockaddr *unix_addr )
+{
+    memset( hdr, 0, sizeof(*hdr) );
     if (async->addr && sock_type != SOCK_STREAM)
     {
-        hdr.msg_name = &unix_addr;
-        hdr.msg_namelen = sockaddr_to_unix( async->addr, async->addr_len, &unix_addr );
-        if (!hdr.msg_namelen)
+        hdr->msg_name = unix_addr;
+        hdr->msg_namelen = sockaddr_to_unix( async->addr, async->addr_len, unix_addr );
+        if (!hdr->msg_namelen)
         {
             ERR( "failed to convert address\n" );
             return STATUS_ACCESS_VIOLATION;
         }
-        if (sock_type == SOCK_DGRAM && ((unix_addr.addr.sa_family == AF_INET && !unix_addr.in.sin_port)
-            || (unix_addr.addr.sa_family == AF_INET6 && !unix_addr.in6.sin6_port)))
+        if (sock_type == SOCK_DGRAM && ((unix_addr->addr.sa_family == AF_INET && !unix_addr->in.sin_port)
+            || (unix_addr->addr.sa_family == AF_INET6 && !unix_addr->in6.sin6_port)))
         {
             /* Sending to port 0 succeeds on Windows. Use 'discard' service instead so sendmsg() works on Unix
              * while still goes through other parameters validation. */
             WARN( "Trying to use destination port 0, substituing 9.\n" );
-            unix_addr.in.sin_port = htons( 9 );
+            unix_addr->in.sin_port = htons( 9 );
         }
 
 #if defined(HAS_IPX) && defined(SOL_IPX)
@@ -1006,13 +1108,40 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
              * the IPX type in the sockaddr_ipx structure with the stored value.
              */
             if (getsockopt(fd, SOL_IPX, IPX_TYPE, &type, &len) >= 0)
-                unix_addr.ipx.sipx_type = type;
+                unix_addr->ipx.sipx_type = type;
         }
 #endif
     }
 
-    hdr.msg_iov = async->iov + async->iov_cursor;
-    hdr.msg_iovlen = async->count - async->iov_cursor;
+    hdr->msg_iov = async->iov + async->iov_cursor;
+    hdr->msg_iovlen = async->count - async->iov_cursor;
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS advance_send( struct async_send_ioctl *async, size_t ret )
+{
+    async->sent_len += ret;
+
+    while (async->iov_cursor < async->count && ret >= async->iov[async->iov_cursor].iov_len)
+        ret -= async->iov[async->iov_cursor++].iov_len;
+    if (async->iov_cursor < async->count)
+    {
+        async->iov[async->iov_cursor].iov_base = (char *)async->iov[async->iov_cursor].iov_base + ret;
+        async->iov[async->iov_cursor].iov_len -= ret;
+        return STATUS_DEVICE_NOT_READY;
+    }
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS try_send( int fd, int sock_type, struct async_send_ioctl *async )
+{
+    union unix_sockaddr unix_addr;
+    struct msghdr hdr;
+    int attempt = 0;
+    NTSTATUS status;
+    ssize_t ret;
+
+    if ((status = init_send_msghdr( fd, sock_type, async, &hdr, &unix_addr ))) return status;
 
     while ((ret = sendmsg( fd, &hdr, async->unix_flags )) == -1)
     {
@@ -1039,33 +1168,89 @@ static NTSTATUS try_send( int fd, struct async_send_ioctl *async )
         }
     }
 
-    async->sent_len += ret;
+    return advance_send( async, ret );
+}
 
-    while (async->iov_cursor < async->count && ret >= async->iov[async->iov_cursor].iov_len)
-        ret -= async->iov[async->iov_cursor++].iov_len;
-    if (async->iov_cursor < async->count)
+static BOOL async_send_proc( void *user, ULONG_PTR *info, unsigned int *status );
+
+#ifdef HAVE_SENDMMSG
+
+#define SEND_BATCH_SIZE 8
+
+/* Send the data of an alerted async along with the asyncs queued after it,
+ * with a single sendmmsg(). The server alerts these asyncs, and they report
+ * the stored result when their own alert gets delivered. */
+static NTSTATUS try_send_batch( int fd, struct async_send_ioctl *async )
+{
+    union unix_sockaddr unix_addrs[SEND_BATCH_SIZE + 1];
+    struct async_send_ioctl *asyncs[SEND_BATCH_SIZE + 1];
+    struct mmsghdr msgs[SEND_BATCH_SIZE + 1];
+    client_ptr_t users[SEND_BATCH_SIZE];
+    unsigned int i, count = 0;
+    int ret;
+
+    SERVER_START_REQ( socket_alert_batch )
     {
-        async->iov[async->iov_cursor].iov_base = (char *)async->iov[async->iov_cursor].iov_base + ret;
-        async->iov[async->iov_cursor].iov_len -= ret;
-        return STATUS_DEVICE_NOT_READY;
+        req->handle = wine_server_obj_handle( async->io.handle );
+        req->user   = wine_server_client_ptr( async );
+        req->write  = 1;
+        wine_server_set_reply( req, users, sizeof(users) );
+        if (!wine_server_call( req )) count = wine_server_reply_size( reply ) / sizeof(users[0]);
     }
-    return STATUS_SUCCESS;
+    SERVER_END_REQ;
+
+    /* the asyncs after one that can't be batched send their data by themselves */
+    asyncs[0] = async;
+    for (i = 0; i <= count; i++)
+    {
+        if (i)
+        {
+            asyncs[i] = wine_server_get_ptr( users[i - 1] );
+            if (asyncs[i]->io.callback != async_send_proc || asyncs[i]->fd != -1 ||
+                asyncs[i]->unix_flags != async->unix_flags)
+                break;
+        }
+        if (init_send_msghdr( fd, SOCK_DGRAM, asyncs[i], &msgs[i].msg_hdr, &unix_addrs[i] )) break;
+    }
+    /* let a single send handle the errors */
+    if ((count = i) < 2) return try_send( fd, SOCK_DGRAM, async );
+
+    while ((ret = sendmmsg( fd, msgs, count, async->unix_flags )) < 0 && errno == EINTR);
+    if (ret <= 0) return try_send( fd, SOCK_DGRAM, async );
+    TRACE( "sent %d datagrams for %u asyncs\n", ret, count );
+
+    for (i = 1; i < ret; i++)
+        if (!advance_send( asyncs[i], msgs[i].msg_len )) asyncs[i]->batch_status = STATUS_SUCCESS;
+    return advance_send( async, msgs[0].msg_len );
 }
 
+#endif
+
 static BOOL async_send_proc( void *user, ULONG_PTR *info, unsigned int *status )
 {
     struct async_send_ioctl *async = user;
-    int fd, needs_close;
+    int fd, needs_close, sock_type;
 
     TRACE( "%#x\n", *status );
 
-    if (*status == STATUS_ALERTED)
+    if (*status == STATUS_ALERTED && async->batch_status != STATUS_PENDING)
+    {
+        /* the data has already been sent along with another async */
+        *status = async->batch_status;
+    }
+    else if (*status == STATUS_ALERTED)
     {
         needs_close = FALSE;
         if ((fd = async->fd) == -1 && (*status = server_get_unix_fd( async->io.handle, 0, &fd, &needs_close, NULL, NULL )))
             return TRUE;
 
-        *status = try_send( fd, async );
+        sock_type = get_fd_sock_type( fd );
+#ifdef HAVE_SENDMMSG
+        if (sock_type == SOCK_DGRAM && async->fd == -1)
+            *status = try_send_batch( fd, async );
+        else
+#endif
+        *status = try_send( fd, sock_type, async );
         TRACE( "got status %#x\n", *status );
 
         if (needs_close) close( fd );
@@ -1131,7 +1316,7 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
 
     if (status == STATUS_ALERTED)
     {
-        status = try_send( fd, async );
+        status = try_send( fd, get_fd_sock_type( fd ), async );
         if (status == STATUS_DEVICE_NOT_READY && ((server_flags & SERVER_SOCKET_IO_FORCE_ASYNC) || !nonblocking))
             status = STATUS_PENDING;
 
@@ -1182,6 +1367,7 @@ static NTSTATUS sock_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, voi
                 rem_async->addr_len = async->addr_len;
                 rem_async->iov_cursor = 0;
                 rem_async->sent_len = 0;
+                rem_async->batch_status = STATUS_PENDING;
                 rem_io = (IO_STATUS_BLOCK *)p;
                 p += sizeof(IO_STATUS_BLOCK);
                 rem_io->Pointer = p;
@@ -1251,6 +1437,7 @@ static NTSTATUS sock_ioctl_send( HANDLE handle, HANDLE event, PIO_APC_ROUTINE ap
     async->addr_len = addr_len;
     async->iov_cursor = 0;
     async->sent_len = 0;
+    async->batch_status = STATUS_PENDING;
 
     return sock_send( handle, event, apc, apc_user, io, fd, async, force_async ? SERVER_SOCKET_IO_FORCE_ASYNC : 0 );
 }
@@ -1274,6 +1461,7 @@ NTSTATUS sock_write( HANDLE handle, int fd, HANDLE event, PIO_APC_ROUTINE apc,
     async->addr_len = 0;
     async->iov_cursor = 0;
     async->sent_len = 0;
+    async->batch_status = STATUS_PENDING;
 
     return sock_send( handle, event, apc, apc_user, io, fd, async, SERVER_SOCKET_IO_FORCE_ASYNC );
 }
@@ -2578,6 +2766,15 @@ NTSTATUS sock_ioctl( HANDLE handle, HANDLE event, PIO_APC_ROUTINE apc, void *apc
         case IOCTL_AFD_WINE_SET_TCP_KEEPCNT:
             return do_setsockopt( handle, io, IPPROTO_TCP, TCP_KEEPCNT, in_buffer, in_size );
 
+#ifdef UDP_SEGMENT
+        /* UDP_SEND_MSG_SIZE on Windows is UDP_SEGMENT (GSO) on Linux */
+        case IOCTL_AFD_WINE_GET_UDP_SEND_MSG_SIZE:
+            return do_getsockopt( handle, io, IPPROTO_UDP, UDP_SEGMENT, out_buffer, out_size );
+
+        case IOCTL_AFD_WINE_SET_UDP_SEND_MSG_SIZE:
+            return do_setsockopt( handle, io, IPPROTO_UDP, UDP_SEGMENT, in_buffer, in_size );
+#endif
+
         default:
         {
             if ((code >> 16) == FILE_DEVICE_NETWORK)
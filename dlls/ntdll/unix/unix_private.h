@@ -30,6 +30,7 @@
 #include "wine/debug.h"
 
 struct msghdr;
+struct mmsghdr;
 
 typedef struct
 {
@@ -291,6 +292,7 @@ extern unsigned int virtual_locked_server_call( void *req_ptr );
 extern ssize_t virtual_locked_read( int fd, void *addr, size_t size );
 extern ssize_t virtual_locked_pread( int fd, void *addr, size_t size, off_t offset );
 extern ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags );
+extern int virtual_locked_recvmmsg( int fd, struct mmsghdr *msgs, unsigned int count, int flags );
 extern BOOL virtual_is_valid_code_address( const void *addr, SIZE_T size );
 extern void *virtual_setup_exception( void *stack_ptr, size_t size, EXCEPTION_RECORD *rec );
 extern BOOL virtual_check_buffer_for_read( const void *ptr, SIZE_T size );
@@ -57,6 +57,11 @@
 #ifdef HAVE_LIBPROCSTAT_H
 # include <libprocstat.h>
 #endif
+#ifdef HAVE_LINUX_USERFAULTFD_H
+# include <sys/ioctl.h>
+# include <linux/fs.h>
+# include <linux/userfaultfd.h>
+#endif
 #include <unistd.h>
 #include <dlfcn.h>
 #ifdef HAVE_VALGRIND_VALGRIND_H
@@ -128,11 +133,13 @@ struct file_view
 #define VPROT_GUARD      0x10
 #define VPROT_COMMITTED  0x20
 #define VPROT_WRITEWATCH 0x40
+#define VPROT_WRITTEN    0x80  /* written before a remap dropped the kernel write watch */
 /* per-mapping protection flags */
 #define VPROT_ARM64EC          0x0100  /* view may contain ARM64EC code */
 #define VPROT_SYSTEM           0x0200  /* system view (underlying mmap not under our control) */
 #define VPROT_PLACEHOLDER      0x0400
 #define VPROT_FREE_PLACEHOLDER 0x0800
+#define VPROT_KERNELWATCH      0x1000  /* write watches are tracked by the kernel */
 
 /* Conversion from VPROT_* to Win32 flags */
 static const BYTE VIRTUAL_Win32Flags[16] =
@@ -156,6 +163,7 @@ static const BYTE VIRTUAL_Win32Flags[16] =
 };
 
 static struct wine_rb_tree views_tree;
+static struct file_view *last_found_view;  /* view returned by the last find_view call */
 static pthread_mutex_t virtual_mutex;
 
 static const UINT page_shift = 12;
@@ -217,6 +225,14 @@ static void *preload_reserve_end;
 static BOOL force_exec_prot;  /* whether to force PROT_EXEC on all PROT_READ mmaps */
 static BOOL enable_write_exceptions;  /* raise exception on writes to executable memory */
 
+/* image mapping statistics, protected by virtual_mutex */
+static struct
+{
+    ULONGLONG mapped;        /* image bytes mapped from files */
+    ULONGLONG read;          /* image bytes copied from files with read() */
+    ULONGLONG reloc_blocks;  /* base relocation blocks applied to images */
+} map_stats;
+
 struct range_entry
 {
     void *base;
@@ -1227,17 +1243,24 @@ static void VIRTUAL_Dump(void)
 static struct file_view *find_view( const void *addr, size_t size )
 {
     struct wine_rb_entry *ptr = views_tree.root;
+    struct file_view *view;
 
     if ((const char *)addr + size < (const char *)addr) return NULL; /* overflow */
 
+    /* repeated operations on the same view are common, check the last one first */
+    if ((view = last_found_view) && view->base <= addr &&
+        (const char *)view->base + view->size >= (const char *)addr + size &&
+        (const char *)view->base + view->size > (const char *)addr)
+        return view;
+
     while (ptr)
     {
-        struct file_view *view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
+        view = WINE_RB_ENTRY_VALUE( ptr, struct file_view, entry );
 
         if (view->base > addr) ptr = ptr->left;
         else if ((const char *)view->base + view->size <= (const char *)addr) ptr = ptr->right;
         else if ((const char *)view->base + view->size < (const char *)addr + size) break;  /* size too large */
-        else return view;
+        else return last_found_view = view;
     }
     return NULL;
 }
@@ -1561,6 +1584,7 @@ static void unregister_view( struct file_view *view )
     if (mmap_is_in_reserved_area( view->base, view->size ))
         free_ranges_remove_view( view );
     wine_rb_remove( &views_tree, &view->entry );
+    if (last_found_view == view) last_found_view = NULL;
 }
 
 
@@ -1761,7 +1785,8 @@ static BOOL set_vprot( struct file_view *view, void *base, size_t size, BYTE vpr
     if (view->protect & VPROT_WRITEWATCH)
     {
         /* each page may need different protections depending on write watch flag */
-        set_page_vprot_bits( base, size, vprot & ~VPROT_WRITEWATCH, ~vprot & ~VPROT_WRITEWATCH );
+        set_page_vprot_bits( base, size, vprot & ~VPROT_WRITEWATCH,
+                             ~vprot & ~(VPROT_WRITEWATCH | VPROT_WRITTEN) );
         mprotect_range( base, size, 0, 0 );
         return TRUE;
     }
@@ -1816,6 +1841,190 @@ static void commit_arm64ec_map( struct file_view *view )
 }
 
 
+#if defined(HAVE_LINUX_USERFAULTFD_H) && defined(PAGEMAP_SCAN) && defined(UFFD_FEATURE_WP_ASYNC) && defined(__NR_userfaultfd)
+
+static BOOL use_kernel_writewatch;  /* write watches are tracked by the kernel */
+static int uffd_fd = -1;
+static int writewatch_pagemap_fd = -1;
+
+/***********************************************************************
+ *           kernel_writewatch_init
+ *
+ * Check if the kernel supports asynchronous userfaultfd write protection
+ * and PAGEMAP_SCAN, which lets write watches work without any page faults.
+ */
+static void kernel_writewatch_init(void)
+{
+    struct uffdio_api uffdio_api;
+    const char *env = getenv( "WINE_DISABLE_KERNEL_WRITEWATCH" );
+
+    if (env && atoi( env )) return;
+
+    if ((uffd_fd = syscall( __NR_userfaultfd, UFFD_USER_MODE_ONLY | O_CLOEXEC | O_NONBLOCK )) == -1)
+        return;
+
+    uffdio_api.api = UFFD_API;
+    uffdio_api.features = UFFD_FEATURE_WP_ASYNC | UFFD_FEATURE_WP_UNPOPULATED;
+    if (ioctl( uffd_fd, UFFDIO_API, &uffdio_api ) || uffdio_api.api != UFFD_API ||
+        (writewatch_pagemap_fd = open( "/proc/self/pagemap", O_RDONLY | O_CLOEXEC )) == -1)
+    {
+        close( uffd_fd );
+        uffd_fd = -1;
+        return;
+    }
+    TRACE( "using kernel write watches\n" );
+    use_kernel_writewatch = TRUE;
+}
+
+/***********************************************************************
+ *           kernel_writewatch_register
+ *
+ * Register a range with userfaultfd write protection.
+ */
+static BOOL kernel_writewatch_register( void *base, SIZE_T size )
+{
+    struct uffdio_register uffdio_register;
+    struct uffdio_writeprotect wp;
+
+    uffdio_register.range.start = (UINT_PTR)base;
+    uffdio_register.range.len = size;
+    uffdio_register.mode = UFFDIO_REGISTER_MODE_WP;
+    if (ioctl( uffd_fd, UFFDIO_REGISTER, &uffdio_register ) == -1)
+    {
+        ERR( "failed to register %p-%p, errno %d\n", base, (char *)base + size, errno );
+        return FALSE;
+    }
+
+    wp.range.start = (UINT_PTR)base;
+    wp.range.len = size;
+    wp.mode = UFFDIO_WRITEPROTECT_MODE_WP;
+    if (ioctl( uffd_fd, UFFDIO_WRITEPROTECT, &wp ) == -1)
+    {
+        ERR( "failed to write protect %p-%p, errno %d\n", base, (char *)base + size, errno );
+        ioctl( uffd_fd, UFFDIO_UNREGISTER, &uffdio_register.range );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/***********************************************************************
+ *           kernel_get_write_watches
+ *
+ * Get the written pages in a range, and optionally reset their write watches.
+ * Returns the number of pages stored in addresses.
+ */
+static ULONG_PTR kernel_get_write_watches( void *base, SIZE_T size, void **addresses,
+                                           ULONG_PTR count, BOOL reset )
+{
+    struct page_region regions[256];
+    struct pm_scan_arg arg;
+    ULONG_PTR pos = 0;
+    char *addr;
+    int i, ret;
+
+    memset( &arg, 0, sizeof(arg) );
+    arg.size = sizeof(arg);
+    arg.start = (UINT_PTR)base;
+    arg.end = arg.start + size;
+    arg.vec = (UINT_PTR)regions;
+    arg.vec_len = ARRAY_SIZE(regions);
+    arg.flags = reset ? PM_SCAN_WP_MATCHING : 0;
+    arg.category_mask = PAGE_IS_WRITTEN;
+    arg.return_mask = PAGE_IS_WRITTEN;
+
+    while (pos < count && arg.start < arg.end)
+    {
+        arg.max_pages = addresses ? count - pos : 0;
+        if ((ret = ioctl( writewatch_pagemap_fd, PAGEMAP_SCAN, &arg )) < 0)
+        {
+            ERR( "PAGEMAP_SCAN failed for %p-%p, errno %d\n", base, (char *)base + size, errno );
+            break;
+        }
+        if (addresses)
+        {
+            for (i = 0; i < ret; i++)
+                for (addr = (char *)(UINT_PTR)regions[i].start; addr < (char *)(UINT_PTR)regions[i].end; addr += page_size)
+                    addresses[pos++] = addr;
+        }
+        arg.start = arg.walk_end;
+    }
+    return pos;
+}
+
+/***********************************************************************
+ *           kernel_writewatch_unregister
+ *
+ * Stop the kernel tracking for a range, and mark the pages that have not
+ * been written with VPROT_WRITEWATCH instead.
+ */
+static void kernel_writewatch_unregister( void *base, SIZE_T size )
+{
+    struct uffdio_range range;
+    struct page_region regions[256];
+    struct pm_scan_arg arg;
+    int i, ret;
+
+    /* protect the pages first so that no write gets lost while scanning */
+    set_page_vprot_bits( base, size, VPROT_WRITEWATCH, 0 );
+    mprotect_range( base, size, 0, 0 );
+
+    memset( &arg, 0, sizeof(arg) );
+    arg.size = sizeof(arg);
+    arg.start = (UINT_PTR)base;
+    arg.end = arg.start + size;
+    arg.vec = (UINT_PTR)regions;
+    arg.vec_len = ARRAY_SIZE(regions);
+    arg.category_mask = PAGE_IS_WRITTEN;
+    arg.return_mask = PAGE_IS_WRITTEN;
+
+    while (arg.start < arg.end)
+    {
+        if ((ret = ioctl( writewatch_pagemap_fd, PAGEMAP_SCAN, &arg )) < 0)
+        {
+            ERR( "PAGEMAP_SCAN failed for %p-%p, errno %d\n", base, (char *)base + size, errno );
+            /* report everything that is left as written */
+            set_page_vprot_bits( (void *)(UINT_PTR)arg.start, arg.end - arg.start, 0, VPROT_WRITEWATCH );
+            break;
+        }
+        for (i = 0; i < ret; i++)
+            set_page_vprot_bits( (void *)(UINT_PTR)regions[i].start, regions[i].end - regions[i].start,
+                                 0, VPROT_WRITEWATCH );
+        arg.start = arg.walk_end;
+    }
+    mprotect_range( base, size, 0, 0 );
+
+    range.start = (UINT_PTR)base;
+    range.len = size;
+    if (ioctl( uffd_fd, UFFDIO_UNREGISTER, &range ) == -1)
+        WARN( "failed to unregister %p-%p, errno %d\n", base, (char *)base + size, errno );
+}
+
+#else
+
+static const BOOL use_kernel_writewatch = FALSE;
+
+static void kernel_writewatch_init(void)
+{
+}
+
+static BOOL kernel_writewatch_register( void *base, SIZE_T size )
+{
+    return FALSE;
+}
+
+static ULONG_PTR kernel_get_write_watches( void *base, SIZE_T size, void **addresses,
+                                           ULONG_PTR count, BOOL reset )
+{
+    return 0;
+}
+
+static void kernel_writewatch_unregister( void *base, SIZE_T size )
+{
+}
+
+#endif
+
+
 /***********************************************************************
  *           update_write_watches
  */
@@ -1834,13 +2043,114 @@ static void update_write_watches( void *base, size_t size, size_t accessed_size
  *
  * Reset write watches in a memory range.
  */
-static void reset_write_watches( void *base, SIZE_T size )
+static void reset_write_watches( struct file_view *view, void *base, SIZE_T size )
 {
+    if (view->protect & VPROT_KERNELWATCH)
+    {
+        kernel_get_write_watches( base, size, NULL, ~(ULONG_PTR)0, TRUE );
+        set_page_vprot_bits( base, size, 0, VPROT_WRITTEN );
+        return;
+    }
     set_page_vprot_bits( base, size, VPROT_WRITEWATCH, 0 );
     mprotect_range( base, size, 0, 0 );
 }
 
 
+/***********************************************************************
+ *           init_write_watches
+ *
+ * Start watching writes in a newly allocated view.
+ */
+static void init_write_watches( struct file_view *view )
+{
+    if (use_kernel_writewatch && kernel_writewatch_register( view->base, view->size ))
+    {
+        /* the kernel tracks the writes, we don't need the page faults */
+        view->protect |= VPROT_KERNELWATCH;
+        set_page_vprot_bits( view->base, view->size, 0, VPROT_WRITEWATCH );
+        mprotect_range( view->base, view->size, 0, 0 );
+    }
+    else reset_write_watches( view, view->base, view->size );
+}
+
+
+/***********************************************************************
+ *           get_kernel_write_watches
+ *
+ * Get the written pages of a view using kernel write watches, including the
+ * pages that were written before being decommitted.
+ */
+static ULONG_PTR get_kernel_write_watches( char *base, SIZE_T size, void **addresses,
+                                           ULONG_PTR count, BOOL reset )
+{
+    char *addr = base, *end = base + size, *start;
+    ULONG_PTR pos = 0;
+
+    while (pos < count && addr < end)
+    {
+        for (start = addr; addr < end; addr += page_size)
+            if (get_page_vprot( addr ) & VPROT_WRITTEN) break;
+        if (addr > start)
+        {
+            pos += kernel_get_write_watches( start, addr - start, addresses + pos, count - pos, reset );
+            if (pos == count) break;
+        }
+        if (addr == end) break;
+
+        addresses[pos++] = addr;
+        if (reset)
+        {
+            kernel_get_write_watches( addr, page_size, NULL, ~(ULONG_PTR)0, TRUE );
+            set_page_vprot_bits( addr, page_size, 0, VPROT_WRITTEN );
+        }
+        addr += page_size;
+    }
+    return pos;
+}
+
+
+/***********************************************************************
+ *           save_kernel_write_watches
+ *
+ * Remember the written pages of a range before remapping it, as the kernel
+ * forgets about them.
+ */
+static void save_kernel_write_watches( char *base, SIZE_T size )
+{
+    char *end = base + size;
+    void *addresses[64];
+    ULONG_PTR i, count;
+
+    do
+    {
+        count = kernel_get_write_watches( base, end - base, addresses, ARRAY_SIZE(addresses), FALSE );
+        for (i = 0; i < count; i++) set_page_vprot_bits( addresses[i], page_size, VPROT_WRITTEN, 0 );
+        if (count) base = (char *)addresses[count - 1] + page_size;
+    } while (count == ARRAY_SIZE(addresses) && base < end);
+}
+
+
+/***********************************************************************
+ *           disable_kernel_write_watches
+ *
+ * Switch a view back to fault based write watches, when the kernel tracking
+ * cannot be restored after remapping some of its pages.
+ */
+static void disable_kernel_write_watches( struct file_view *view )
+{
+    char *addr, *end = (char *)view->base + view->size;
+
+    if (!(view->protect & VPROT_KERNELWATCH)) return;
+    kernel_writewatch_unregister( view->base, view->size );
+    view->protect &= ~VPROT_KERNELWATCH;
+
+    for (addr = view->base; addr < end; addr += page_size)
+        if (get_page_vprot( addr ) & VPROT_WRITTEN)
+            set_page_vprot_bits( addr, page_size, 0, VPROT_WRITEWATCH | VPROT_WRITTEN );
+    mprotect_range( view->base, view->size, 0, 0 );
+}
+
+
 /***********************************************************************
  *           unmap_extra_space
  *
@@ -2027,7 +2337,6 @@ static NTSTATUS map_view( struct file_view **view_ret, void *base, size_t size,
 
         view->protect = vprot | VPROT_PLACEHOLDER;
         set_vprot( view, base, size, vprot );
-        if (vprot & VPROT_WRITEWATCH) reset_write_watches( base, size );
         *view_ret = view;
         return STATUS_SUCCESS;
     }
@@ -2122,7 +2431,10 @@ static NTSTATUS map_file_into_view( struct file_view *view, int fd, size_t start
     if (!removable || (flags & MAP_SHARED))
     {
         if (mmap( (char *)view->base + start, size, prot, flags, fd, offset ) != MAP_FAILED)
+        {
+            if (view->protect & SEC_IMAGE) map_stats.mapped += size;
             return STATUS_SUCCESS;
+        }
 
         switch (errno)
         {
@@ -2163,6 +2475,7 @@ static NTSTATUS map_file_into_view( struct file_view *view, int fd, size_t start
     }
     /* Now read in the file */
     pread( fd, ptr, size, offset );
+    if (view->protect & SEC_IMAGE) map_stats.read += size;
     return STATUS_SUCCESS;
 }
 
@@ -2219,9 +2532,13 @@ static SIZE_T get_committed_size( struct file_view *view, void *base, size_t max
 static NTSTATUS decommit_pages( struct file_view *view, char *base, size_t size )
 {
     if (!size) size = view->size;
+    if (view->protect & VPROT_KERNELWATCH) save_kernel_write_watches( base, size );
     if (anon_mmap_fixed( base, size, PROT_NONE, 0 ) != MAP_FAILED)
     {
         set_page_vprot_bits( base, size, 0, VPROT_COMMITTED );
+        /* the new mapping isn't registered with userfaultfd anymore */
+        if ((view->protect & VPROT_KERNELWATCH) && !kernel_writewatch_register( base, size ))
+            disable_kernel_write_watches( view );
         return STATUS_SUCCESS;
     }
     return STATUS_NO_MEMORY;
@@ -2449,7 +2766,12 @@ static NTSTATUS map_pe_header( void *ptr, size_t size, size_t map_size, int fd,
         if (mmap( ptr, map_size, PROT_READ | PROT_WRITE | PROT_EXEC,
                   MAP_FIXED | MAP_PRIVATE, fd, 0 ) != MAP_FAILED)
         {
-            if (size > map_size) pread( fd, (char *)ptr + map_size, size - map_size, map_size );
+            map_stats.mapped += map_size;
+            if (size > map_size)
+            {
+                pread( fd, (char *)ptr + map_size, size - map_size, map_size );
+                map_stats.read += size - map_size;
+            }
             return STATUS_SUCCESS;
         }
         switch (errno)
@@ -2469,6 +2791,7 @@ static NTSTATUS map_pe_header( void *ptr, size_t size, size_t map_size, int fd,
         *removable = TRUE;
     }
     pread( fd, ptr, size, 0 );
+    map_stats.read += size;
     return STATUS_SUCCESS;  /* page protections will be updated later */
 }
 
@@ -2941,7 +3264,10 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
             IMAGE_BASE_RELOCATION *end = (IMAGE_BASE_RELOCATION *)((char *)rel + dir->Size);
 
             while (rel && rel < end - 1 && rel->SizeOfBlock && rel->VirtualAddress < total_size)
+            {
                 rel = process_relocation_block( ptr + rel->VirtualAddress, rel, delta );
+                map_stats.reloc_blocks++;
+            }
         }
     }
 
@@ -2971,6 +3297,9 @@ static NTSTATUS map_image_into_view( struct file_view *view, const WCHAR *filena
 #ifdef VALGRIND_LOAD_PDB_DEBUGINFO
     VALGRIND_LOAD_PDB_DEBUGINFO(fd, ptr, total_size, ptr - (char *)wine_server_get_ptr( image_info->base ));
 #endif
+    TRACE_(module)( "mapped %s, process totals: %s bytes mapped, %s bytes read, %s relocation blocks\n",
+                    debugstr_w(filename), wine_dbgstr_longlong( map_stats.mapped ),
+                    wine_dbgstr_longlong( map_stats.read ), wine_dbgstr_longlong( map_stats.reloc_blocks ));
     status = STATUS_SUCCESS;
 
 done:
@@ -3398,6 +3727,8 @@ void virtual_init(void)
     size = (char *)address_space_start - (char *)0x10000;
     if (size && mmap_is_in_reserved_area( (void*)0x10000, size ) == 1)
         anon_mmap_fixed( (void *)0x10000, size, PROT_READ | PROT_WRITE, 0 );
+
+    kernel_writewatch_init();
 }
 
 
@@ -4291,6 +4622,69 @@ ssize_t virtual_locked_recvmsg( int fd, struct msghdr *hdr, int flags )
 }
 
 
+#ifdef HAVE_RECVMMSG
+
+/***********************************************************************
+ *           is_write_accessible
+ *
+ * Check if the memory range can be written without causing a page fault.
+ */
+static BOOL is_write_accessible( void *base, size_t size )
+{
+    char *addr = ROUND_ADDR( base, page_mask );
+    size_t i;
+
+    size = ROUND_SIZE( base, size, page_mask );
+    for (i = 0; i < size; i += page_size)
+        if (!(get_unix_prot( get_page_vprot( addr + i )) & PROT_WRITE)) return FALSE;
+    return TRUE;
+}
+
+
+/***********************************************************************
+ *           virtual_locked_recvmmsg
+ *
+ * A fault on the buffers of a message after the first one would drop its
+ * datagram, so the batch stops at the first message that isn't writable.
+ */
+int virtual_locked_recvmmsg( int fd, struct mmsghdr *msgs, unsigned int count, int flags )
+{
+    sigset_t sigset;
+    unsigned int i, j;
+    ssize_t size;
+    int ret = -1, err = 0;
+
+    server_enter_uninterrupted_section( &virtual_mutex, &sigset );
+    for (i = 0; i < count; i++)
+    {
+        struct msghdr *hdr = &msgs[i].msg_hdr;
+
+        for (j = 0; j < hdr->msg_iovlen; j++)
+            if (!is_write_accessible( hdr->msg_iov[j].iov_base, hdr->msg_iov[j].iov_len )) break;
+        if (j < hdr->msg_iovlen) break;
+    }
+    if (i)
+    {
+        ret = recvmmsg( fd, msgs, i, flags, NULL );
+        err = errno;
+    }
+    server_leave_uninterrupted_section( &virtual_mutex, &sigset );
+
+    if (i)
+    {
+        errno = err;
+        return ret;
+    }
+
+    /* the first buffer needs its write watches updated */
+    if ((size = virtual_locked_recvmsg( fd, &msgs[0].msg_hdr, flags )) < 0) return -1;
+    msgs[0].msg_len = size;
+    return 1;
+}
+
+#endif
+
+
 /***********************************************************************
  *           virtual_is_valid_code_address
  */
@@ -4630,12 +5024,14 @@ static NTSTATUS allocate_virtual_memory( void **ret, SIZE_T *size_ptr, ULONG typ
                                     align ? align - 1 : granularity_mask );
 
             if (status == STATUS_SUCCESS) base = view->base;
+            if (status == STATUS_SUCCESS && (vprot & VPROT_WRITEWATCH)) init_write_watches( view );
         }
     }
     else if (type & MEM_RESET)
     {
         if (!(view = find_view( base, size ))) status = STATUS_NOT_MAPPED_VIEW;
-        else madvise( base, size, MADV_DONTNEED );
+        /* MEM_RESET is only a hint, discarding the pages would lose their written state */
+        else if (!(view->protect & VPROT_KERNELWATCH)) madvise( base, size, MADV_DONTNEED );
     }
     else  /* commit the pages */
     {
@@ -5149,7 +5545,8 @@ static unsigned int fill_basic_memory_info( const void *addr, MEMORY_BASIC_INFOR
         BYTE vprot;
 
         info->AllocationBase = alloc_base;
-        info->RegionSize = get_committed_size( view, base, ~(size_t)0, &vprot, ~VPROT_WRITEWATCH );
+        info->RegionSize = get_committed_size( view, base, ~(size_t)0, &vprot,
+                                               (BYTE)~(VPROT_WRITEWATCH | VPROT_WRITTEN) );
         info->State = (vprot & VPROT_COMMITTED) ? MEM_COMMIT : MEM_RESERVE;
         info->Protect = (vprot & VPROT_COMMITTED) ? get_win32_prot( vprot, view->protect ) : 0;
         info->AllocationProtect = get_win32_prot( view->protect, view->protect );
@@ -5440,7 +5837,8 @@ static NTSTATUS get_working_set_ex( HANDLE process, LPCVOID addr,
         while (start != (char *)view->base + view->size && r != ref + count
                && r->addr < (char *)view->base + view->size)
         {
-            start += get_committed_size( view, start, end - start, &vprot, ~VPROT_WRITEWATCH );
+            start += get_committed_size( view, start, end - start, &vprot,
+                                         (BYTE)~(VPROT_WRITEWATCH | VPROT_WRITTEN) );
             i = 0;
             while (r + i != ref + count && r[i].addr < start) ++i;
             if (vprot & VPROT_COMMITTED) fill_working_set_info( &data, view, vprot, r, i, info );
@@ -6038,6 +6436,7 @@ NTSTATUS WINAPI NtFlushVirtualMemory( HANDLE process, LPCVOID *addr_ptr,
 NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T size, PVOID *addresses,
                                  ULONG_PTR *count, ULONG *granularity )
 {
+    struct file_view *view;
     NTSTATUS status = STATUS_SUCCESS;
     sigset_t sigset;
 
@@ -6055,7 +6454,14 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
 
     server_enter_uninterrupted_section( &virtual_mutex, &sigset );
 
-    if (is_write_watch_range( base, size ))
+    if (!(view = find_view( base, size )) || !(view->protect & VPROT_WRITEWATCH))
+        status = STATUS_INVALID_PARAMETER;
+    else if (view->protect & VPROT_KERNELWATCH)
+    {
+        *count = get_kernel_write_watches( base, size, addresses, *count, flags & WRITE_WATCH_FLAG_RESET );
+        *granularity = page_size;
+    }
+    else
     {
         ULONG_PTR pos = 0;
         char *addr = base;
@@ -6066,11 +6472,10 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
             if (!(get_page_vprot( addr ) & VPROT_WRITEWATCH)) addresses[pos++] = addr;
             addr += page_size;
         }
-        if (flags & WRITE_WATCH_FLAG_RESET) reset_write_watches( base, addr - (char *)base );
+        if (flags & WRITE_WATCH_FLAG_RESET) reset_write_watches( view, base, addr - (char *)base );
         *count = pos;
         *granularity = page_size;
     }
-    else status = STATUS_INVALID_PARAMETER;
 
     server_leave_uninterrupted_section( &virtual_mutex, &sigset );
     return status;
@@ -6083,6 +6488,7 @@ NTSTATUS WINAPI NtGetWriteWatch( HANDLE process, ULONG flags, PVOID base, SIZE_T
  */
 NTSTATUS WINAPI NtResetWriteWatch( HANDLE process, PVOID base, SIZE_T size )
 {
+    struct file_view *view;
     NTSTATUS status = STATUS_SUCCESS;
     sigset_t sigset;
 
@@ -6095,8 +6501,8 @@ NTSTATUS WINAPI NtResetWriteWatch( HANDLE process, PVOID base, SIZE_T size )
 
     server_enter_uninterrupted_section( &virtual_mutex, &sigset );
 
-    if (is_write_watch_range( base, size ))
-        reset_write_watches( base, size );
+    if ((view = find_view( base, size )) && (view->protect & VPROT_WRITEWATCH))
+        reset_write_watches( view, base, size );
     else
         status = STATUS_INVALID_PARAMETER;
 
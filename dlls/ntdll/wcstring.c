@@ -33,6 +33,7 @@
 #include "winnls.h"
 #include "winternl.h"
 #include "ntdll_misc.h"
+#include "wine/wordscan.h"
 
 static const unsigned short wctypes[256] =
 {
@@ -215,7 +216,12 @@ errno_t __cdecl wcscpy_s( wchar_t *dst, size_t len, const wchar_t *src )
 size_t __cdecl wcslen( LPCWSTR str )
 {
     const WCHAR *s = str;
-    while (*s) s++;
+    const size_t *w;
+
+    /* misaligned strings never reach word alignment and are simply scanned here */
+    for ( ; !word_is_aligned( s ); s++) if (!*s) return s - str;
+    for (w = (const size_t *)s; !word_has_zero_wchar( *w ); w++) ;
+    for (s = (const WCHAR *)w; *s; s++) ;
     return s - str;
 }
 
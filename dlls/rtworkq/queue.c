@@ -131,7 +131,6 @@ enum system_queue_index
 
 enum work_item_type
 {
-    WORK_ITEM_WORK,
     WORK_ITEM_TIMER,
     WORK_ITEM_WAIT,
 };
@@ -141,6 +140,8 @@ struct work_item
     IUnknown IUnknown_iface;
     LONG refcount;
     struct list entry;
+    struct list ready_entry;
+    LARGE_INTEGER submit_time;
     IRtwqAsyncResult *result;
     IRtwqAsyncResult *reply_result;
     struct queue *queue;
@@ -151,7 +152,6 @@ struct work_item
     enum work_item_type type;
     union
     {
-        TP_WORK *work_object;
         TP_WAIT *wait_object;
         TP_TIMER *timer_object;
     } u;
@@ -195,6 +195,13 @@ struct queue
     CRITICAL_SECTION cs;
     struct list pending_items;
     DWORD id;
+    /* Data used for pool queues only. */
+    SRWLOCK ready_lock;
+    struct list ready_items[ARRAY_SIZE(priorities)];
+    TP_WORK *work_objects[ARRAY_SIZE(priorities)];
+    UINT64 dispatched;
+    UINT64 total_latency;
+    UINT64 max_latency;
     /* Data used for serial queues only. */
     PTP_SIMPLE_CALLBACK finalization_callback;
     DWORD target_queue;
@@ -332,12 +339,53 @@ static void CALLBACK standard_queue_cleanup_callback(void *object_data, void *gr
 {
 }
 
+static void CALLBACK pool_queue_worker(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
+{
+    struct queue *queue = context;
+    RTWQASYNCRESULT *result;
+    struct work_item *item;
+    LARGE_INTEGER now;
+    unsigned int i;
+    UINT64 latency;
+
+    for (i = 0; i < ARRAY_SIZE(queue->work_objects); ++i)
+        if (queue->work_objects[i] == work) break;
+    assert(i < ARRAY_SIZE(queue->work_objects));
+
+    QueryPerformanceCounter(&now);
+
+    /* Each submission queued exactly one item, so the list can't be empty here. */
+    AcquireSRWLockExclusive(&queue->ready_lock);
+    item = LIST_ENTRY(list_head(&queue->ready_items[i]), struct work_item, ready_entry);
+    list_remove(&item->ready_entry);
+    latency = now.QuadPart - item->submit_time.QuadPart;
+    queue->dispatched++;
+    queue->total_latency += latency;
+    if (latency > queue->max_latency) queue->max_latency = latency;
+    ReleaseSRWLockExclusive(&queue->ready_lock);
+
+    result = (RTWQASYNCRESULT *)item->result;
+    TRACE("result object %p.\n", result);
+
+    /* Submitting from serial queue in reply mode, use different result object acting as receipt token.
+       It's submitted to user callback still, but when invoked, special serial queue callback will be used
+       to ensure correct destination queue. */
+
+    IRtwqAsyncCallback_Invoke(result->pCallback, item->reply_result ? item->reply_result : item->result);
+
+    if (item->finalization_callback)
+        item->finalization_callback(instance, item);
+
+    IUnknown_Release(&item->IUnknown_iface);
+}
+
 static HRESULT pool_queue_init(const struct queue_desc *desc, struct queue *queue)
 {
     TP_CALLBACK_ENVIRON_V3 env;
     unsigned int max_thread, i;
 
-    queue->pool = CreateThreadpool(NULL);
+    if (!(queue->pool = CreateThreadpool(NULL)))
+        return E_OUTOFMEMORY;
 
     memset(&env, 0, sizeof(env));
     env.Version = 3;
@@ -351,6 +399,24 @@ static HRESULT pool_queue_init(const struct queue_desc *desc, struct queue *queu
         queue->envs[i] = env;
         queue->envs[i].CallbackPriority = priorities[i];
     }
+
+    /* Work objects are shared by all items of the same priority, and submitted once per item. */
+    InitializeSRWLock(&queue->ready_lock);
+    for (i = 0; i < ARRAY_SIZE(queue->envs); ++i)
+    {
+        list_init(&queue->ready_items[i]);
+        if (!(queue->work_objects[i] = CreateThreadpoolWork(pool_queue_worker, queue,
+                (TP_CALLBACK_ENVIRON *)&queue->envs[i])))
+        {
+            WARN("Failed to create work object.\n");
+            CloseThreadpoolCleanupGroupMembers(env.CleanupGroup, FALSE, NULL);
+            CloseThreadpoolCleanupGroup(env.CleanupGroup);
+            CloseThreadpool(queue->pool);
+            queue->pool = NULL;
+            return E_OUTOFMEMORY;
+        }
+    }
+
     list_init(&queue->pending_items);
     InitializeCriticalSection(&queue->cs);
 
@@ -370,33 +436,28 @@ static BOOL pool_queue_shutdown(struct queue *queue)
     if (!queue->pool)
         return FALSE;
 
+    /* Wait for all submitted items, this also closes the work objects. */
     CloseThreadpoolCleanupGroupMembers(queue->envs[0].CleanupGroup, FALSE, NULL);
-    CloseThreadpool(queue->pool);
-    queue->pool = NULL;
 
-    return TRUE;
-}
-
-static void CALLBACK standard_queue_worker(TP_CALLBACK_INSTANCE *instance, void *context, TP_WORK *work)
-{
-    struct work_item *item = context;
-    RTWQASYNCRESULT *result = (RTWQASYNCRESULT *)item->result;
-
-    TRACE("result object %p.\n", result);
+    if (TRACE_ON(mfplat) && queue->dispatched)
+    {
+        LARGE_INTEGER freq;
 
-    /* Submitting from serial queue in reply mode, use different result object acting as receipt token.
-       It's submitted to user callback still, but when invoked, special serial queue callback will be used
-       to ensure correct destination queue. */
+        QueryPerformanceFrequency(&freq);
+        TRACE("queue %p dispatched %I64u items, average latency %I64u us, max latency %I64u us.\n", queue,
+                queue->dispatched, queue->total_latency / queue->dispatched * 1000000 / freq.QuadPart,
+                queue->max_latency * 1000000 / freq.QuadPart);
+    }
 
-    IRtwqAsyncCallback_Invoke(result->pCallback, item->reply_result ? item->reply_result : item->result);
+    CloseThreadpool(queue->pool);
+    queue->pool = NULL;
 
-    IUnknown_Release(&item->IUnknown_iface);
+    return TRUE;
 }
 
 static void pool_queue_submit(struct queue *queue, struct work_item *item)
 {
     TP_CALLBACK_PRIORITY callback_priority;
-    TP_CALLBACK_ENVIRON_V3 env;
 
     if (item->priority == 0)
         callback_priority = TP_CALLBACK_PRIORITY_NORMAL;
@@ -405,15 +466,17 @@ static void pool_queue_submit(struct queue *queue, struct work_item *item)
     else
         callback_priority = TP_CALLBACK_PRIORITY_HIGH;
 
-    env = queue->envs[callback_priority];
-    env.FinalizationCallback = item->finalization_callback;
     /* Worker pool callback will release one reference. Grab one more to keep object alive when
        we need finalization callback. */
     if (item->finalization_callback)
         IUnknown_AddRef(&item->IUnknown_iface);
-    item->u.work_object = CreateThreadpoolWork(standard_queue_worker, item, (TP_CALLBACK_ENVIRON *)&env);
-    item->type = WORK_ITEM_WORK;
-    SubmitThreadpoolWork(item->u.work_object);
+
+    AcquireSRWLockExclusive(&queue->ready_lock);
+    QueryPerformanceCounter(&item->submit_time);
+    list_add_tail(&queue->ready_items[callback_priority], &item->ready_entry);
+    ReleaseSRWLockExclusive(&queue->ready_lock);
+
+    SubmitThreadpoolWork(queue->work_objects[callback_priority]);
 
     TRACE("dispatched %p.\n", item->result);
 }
@@ -576,9 +639,6 @@ static ULONG WINAPI work_item_Release(IUnknown *iface)
     {
         switch (item->type)
         {
-            case WORK_ITEM_WORK:
-                if (item->u.work_object) CloseThreadpoolWork(item->u.work_object);
-                break;
             case WORK_ITEM_WAIT:
                 if (item->u.wait_object) CloseThreadpoolWait(item->u.wait_object);
                 break;
@@ -624,16 +684,20 @@ static struct work_item * alloc_work_item(struct queue *queue, LONG priority, IR
     return item;
 }
 
-static void init_work_queue(const struct queue_desc *desc, struct queue *queue)
+static HRESULT init_work_queue(const struct queue_desc *desc, struct queue *queue)
 {
+    HRESULT hr;
+
     assert(desc->ops != NULL);
 
     queue->ops = desc->ops;
-    if (SUCCEEDED(queue->ops->init(desc, queue)))
+    if (SUCCEEDED(hr = queue->ops->init(desc, queue)))
     {
         list_init(&queue->pending_items);
         InitializeCriticalSection(&queue->cs);
     }
+
+    return hr;
 }
 
 static HRESULT grab_queue(DWORD queue_id, struct queue **ret)
@@ -655,6 +719,7 @@ static HRESULT grab_queue(DWORD queue_id, struct queue **ret)
     else if (queue)
     {
         struct queue_desc desc;
+        HRESULT hr;
 
         EnterCriticalSection(&queues_section);
         switch (queue_id)
@@ -671,8 +736,10 @@ static HRESULT grab_queue(DWORD queue_id, struct queue **ret)
         desc.queue_type = queue_type;
         desc.ops = &pool_queue_ops;
         desc.target_queue = 0;
-        init_work_queue(&desc, queue);
+        hr = init_work_queue(&desc, queue);
         LeaveCriticalSection(&queues_section);
+        if (FAILED(hr))
+            return hr;
         *ret = queue;
         return S_OK;
     }
@@ -967,6 +1034,7 @@ static HRESULT alloc_user_queue(const struct queue_desc *desc, DWORD *queue_id)
     struct queue_handle *entry;
     struct queue *queue;
     unsigned int idx;
+    HRESULT hr;
 
     *queue_id = RTWQ_CALLBACK_QUEUE_UNDEFINED;
 
@@ -976,7 +1044,11 @@ static HRESULT alloc_user_queue(const struct queue_desc *desc, DWORD *queue_id)
     if (!(queue = calloc(1, sizeof(*queue))))
         return E_OUTOFMEMORY;
 
-    init_work_queue(desc, queue);
+    if (FAILED(hr = init_work_queue(desc, queue)))
+    {
+        free(queue);
+        return hr;
+    }
 
     EnterCriticalSection(&queues_section);
 
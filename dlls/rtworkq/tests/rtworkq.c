@@ -293,6 +293,96 @@ static void test_undefined_queue_id(void)
     ok(hr == S_OK, "Failed to shut down, hr %#lx.\n", hr);
 }
 
+struct order_callback
+{
+    IRtwqAsyncCallback IRtwqAsyncCallback_iface;
+    HANDLE event;
+    LONG count;
+    IRtwqAsyncResult *results[64];
+};
+
+static struct order_callback *order_impl_from_IRtwqAsyncCallback(IRtwqAsyncCallback *iface)
+{
+    return CONTAINING_RECORD(iface, struct order_callback, IRtwqAsyncCallback_iface);
+}
+
+static ULONG WINAPI order_callback_AddRef(IRtwqAsyncCallback *iface)
+{
+    return 2;
+}
+
+static ULONG WINAPI order_callback_Release(IRtwqAsyncCallback *iface)
+{
+    return 1;
+}
+
+static HRESULT WINAPI order_callback_Invoke(IRtwqAsyncCallback *iface, IRtwqAsyncResult *result)
+{
+    struct order_callback *callback = order_impl_from_IRtwqAsyncCallback(iface);
+    LONG count = InterlockedIncrement(&callback->count);
+
+    if (count <= ARRAY_SIZE(callback->results))
+        callback->results[count - 1] = result;
+    if (count == ARRAY_SIZE(callback->results))
+        SetEvent(callback->event);
+
+    return S_OK;
+}
+
+static const IRtwqAsyncCallbackVtbl order_callback_vtbl =
+{
+    testcallback_QueryInterface,
+    order_callback_AddRef,
+    order_callback_Release,
+    testcallback_GetParameters,
+    order_callback_Invoke,
+};
+
+static void test_work_queue_order(void)
+{
+    struct order_callback callback = {{&order_callback_vtbl}};
+    IRtwqAsyncResult *results[ARRAY_SIZE(callback.results)];
+    DWORD res, queue;
+    unsigned int i;
+    HRESULT hr;
+
+    hr = RtwqStartup();
+    ok(hr == S_OK, "Failed to start up, hr %#lx.\n", hr);
+
+    hr = RtwqAllocateWorkQueue(RTWQ_STANDARD_WORKQUEUE, &queue);
+    ok(hr == S_OK, "Failed to allocate a queue, hr %#lx.\n", hr);
+
+    callback.event = CreateEventA(NULL, FALSE, FALSE, NULL);
+    for (i = 0; i < ARRAY_SIZE(results); ++i)
+    {
+        hr = RtwqCreateAsyncResult(NULL, &callback.IRtwqAsyncCallback_iface, NULL, &results[i]);
+        ok(hr == S_OK, "Failed to create result, hr %#lx.\n", hr);
+    }
+
+    /* Items submitted to a standard queue are invoked in order. */
+    for (i = 0; i < ARRAY_SIZE(results); ++i)
+    {
+        hr = RtwqPutWorkItem(queue, 0, results[i]);
+        ok(hr == S_OK, "Failed to submit item, hr %#lx.\n", hr);
+    }
+
+    res = WaitForSingleObject(callback.event, 1000);
+    ok(res == WAIT_OBJECT_0, "Unexpected wait result %#lx.\n", res);
+    for (i = 0; i < ARRAY_SIZE(results); ++i)
+        ok(callback.results[i] == results[i], "Unexpected result %p at %u.\n", callback.results[i], i);
+
+    hr = RtwqUnlockWorkQueue(queue);
+    ok(hr == S_OK, "Failed to unlock the queue, hr %#lx.\n", hr);
+    ok(callback.count == ARRAY_SIZE(results), "Unexpected count %ld.\n", callback.count);
+
+    for (i = 0; i < ARRAY_SIZE(results); ++i)
+        IRtwqAsyncResult_Release(results[i]);
+    CloseHandle(callback.event);
+
+    hr = RtwqShutdown();
+    ok(hr == S_OK, "Failed to shut down, hr %#lx.\n", hr);
+}
+
 static void test_work_queue(void)
 {
     IRtwqAsyncResult *result, *result2, *callback_result;
@@ -608,6 +698,7 @@ START_TEST(rtworkq)
     test_platform_init();
     test_undefined_queue_id();
     test_work_queue();
+    test_work_queue_order();
     test_scheduled_items();
     test_queue_shutdown();
 }
@@ -30,6 +30,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <dlfcn.h>
 #ifdef SONAME_LIBGNUTLS
@@ -78,8 +79,13 @@ static int (*pgnutls_privkey_import_rsa_raw)(gnutls_privkey_t, const gnutls_datu
                                         const gnutls_datum_t *);
 
 /* Not present in gnutls version < 3.4.0. */
+static int (*pgnutls_certificate_get_crt_raw)(gnutls_certificate_credentials_t, unsigned, unsigned,
+                                              gnutls_datum_t *);
 static int (*pgnutls_privkey_export_x509)(gnutls_privkey_t, gnutls_x509_privkey_t *);
 
+/* Not present in gnutls version < 3.5.0. */
+static unsigned int (*pgnutls_session_get_flags)(gnutls_session_t);
+
 static void *libgnutls_handle;
 #define MAKE_FUNCPTR(f) static typeof(f) * p##f
 MAKE_FUNCPTR(gnutls_alert_get);
@@ -112,6 +118,8 @@ MAKE_FUNCPTR(gnutls_record_recv);
 MAKE_FUNCPTR(gnutls_record_send);
 MAKE_FUNCPTR(gnutls_server_name_set);
 MAKE_FUNCPTR(gnutls_session_channel_binding);
+MAKE_FUNCPTR(gnutls_session_get_data);
+MAKE_FUNCPTR(gnutls_session_set_data);
 MAKE_FUNCPTR(gnutls_set_default_priority);
 MAKE_FUNCPTR(gnutls_transport_get_ptr);
 MAKE_FUNCPTR(gnutls_transport_set_errno);
@@ -146,6 +154,11 @@ MAKE_FUNCPTR(gnutls_x509_privkey_deinit);
 #define GNUTLS_ALPN_SERVER_PRECEDENCE (1<<1)
 #endif
 
+#if GNUTLS_VERSION_MAJOR < 3 || (GNUTLS_VERSION_MAJOR == 3 && GNUTLS_VERSION_MINOR < 6)
+#define GNUTLS_TLS1_3 5
+#define GNUTLS_SFLAGS_SESSION_TICKET (1<<7)
+#endif
+
 static inline gnutls_session_t session_from_handle(UINT64 handle)
 {
    return (gnutls_session_t)(ULONG_PTR)handle;
@@ -169,8 +182,126 @@ struct schan_transport
     gnutls_session_t session;
     struct schan_buffers in;
     struct schan_buffers out;
+    BOOL client;
+    BOOL handshake_done;
+    BOOL cacheable;
+    void *cert;
+    size_t cert_size;
+    DWORD protocols;
+    char *target;
+};
+
+/* Client sessions are cached per target name, client certificate and
+ * protocols, so that new connections to a server can resume a previous
+ * session instead of going through a full handshake. Credential handles
+ * aren't used as a key, as they are reused once freed. */
+struct session_cache_entry
+{
+    char *target;
+    void *cert;
+    size_t cert_size;
+    DWORD protocols;
+    BOOL single_use;
+    void *data;
+    size_t size;
 };
 
+#define SESSION_CACHE_SIZE 16
+static struct session_cache_entry session_cache[SESSION_CACHE_SIZE];
+static unsigned int session_cache_next;
+static pthread_mutex_t session_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* must be called with session_cache_mutex held */
+static struct session_cache_entry *find_cached_session(struct schan_transport *t)
+{
+    unsigned int i;
+
+    for (i = 0; i < SESSION_CACHE_SIZE; i++)
+    {
+        struct session_cache_entry *entry = &session_cache[i];
+        if (entry->target && entry->protocols == t->protocols && !strcmp(entry->target, t->target)
+                && entry->cert_size == t->cert_size
+                && (!t->cert_size || !memcmp(entry->cert, t->cert, t->cert_size)))
+            return entry;
+    }
+    return NULL;
+}
+
+/* must be called with session_cache_mutex held */
+static void free_cached_session(struct session_cache_entry *entry)
+{
+    free(entry->target);
+    free(entry->cert);
+    free(entry->data);
+    memset(entry, 0, sizeof(*entry));
+}
+
+/* Copy the client certificate of the credentials, to look up cached sessions. */
+static void set_session_cert(struct schan_transport *t, gnutls_certificate_credentials_t creds)
+{
+    gnutls_datum_t cert;
+    int err;
+
+    if ((err = pgnutls_certificate_get_crt_raw(creds, 0, 0, &cert)) == GNUTLS_E_REQUESTED_DATA_NOT_AVAILABLE)
+    {
+        t->cacheable = TRUE;
+        return;
+    }
+    if (err != GNUTLS_E_SUCCESS || !(t->cert = malloc(cert.size))) return;
+    memcpy(t->cert, cert.data, cert.size);
+    t->cert_size = cert.size;
+    t->cacheable = TRUE;
+}
+
+/* TLS 1.3 session data is only a placeholder until the server sent a ticket */
+static BOOL session_is_resumable(struct schan_transport *t)
+{
+    if (pgnutls_protocol_get_version(t->session) != GNUTLS_TLS1_3) return TRUE;
+    return !!(pgnutls_session_get_flags(t->session) & GNUTLS_SFLAGS_SESSION_TICKET);
+}
+
+static void cache_session(struct schan_transport *t)
+{
+    struct session_cache_entry *entry;
+    size_t size = 0;
+    void *data;
+    int err;
+
+    if (!t->client || !t->target || !t->cacheable || !session_is_resumable(t)) return;
+
+    err = pgnutls_session_get_data(t->session, NULL, &size);
+    if ((err != GNUTLS_E_SUCCESS && err != GNUTLS_E_SHORT_MEMORY_BUFFER) || !size) return;
+    if (!(data = malloc(size))) return;
+    if (pgnutls_session_get_data(t->session, data, &size) != GNUTLS_E_SUCCESS)
+    {
+        free(data);
+        return;
+    }
+
+    pthread_mutex_lock(&session_cache_mutex);
+    if (!(entry = find_cached_session(t)))
+    {
+        entry = &session_cache[session_cache_next++ % SESSION_CACHE_SIZE];
+        free_cached_session(entry);
+        if (!(entry->target = strdup(t->target)) || (t->cert_size && !(entry->cert = malloc(t->cert_size))))
+        {
+            free_cached_session(entry);
+            pthread_mutex_unlock(&session_cache_mutex);
+            free(data);
+            return;
+        }
+        if (t->cert_size) memcpy(entry->cert, t->cert, t->cert_size);
+        entry->cert_size = t->cert_size;
+        entry->protocols = t->protocols;
+    }
+    free(entry->data);
+    entry->data = data;
+    entry->size = size;
+    /* TLS 1.3 tickets should only be used once */
+    entry->single_use = pgnutls_protocol_get_version(t->session) == GNUTLS_TLS1_3;
+    pthread_mutex_unlock(&session_cache_mutex);
+}
+
 static int compat_cipher_get_block_size(gnutls_cipher_algorithm_t cipher)
 {
     switch(cipher) {
@@ -229,6 +360,19 @@ static int compat_gnutls_alpn_set_protocols(gnutls_session_t session, const gnut
     return GNUTLS_E_INVALID_REQUEST;
 }
 
+static int compat_gnutls_certificate_get_crt_raw(gnutls_certificate_credentials_t sc, unsigned idx1,
+                                                 unsigned idx2, gnutls_datum_t *cert)
+{
+    FIXME("\n");
+    return GNUTLS_E_INVALID_REQUEST;
+}
+
+static unsigned int compat_gnutls_session_get_flags(gnutls_session_t session)
+{
+    FIXME("\n");
+    return 0;
+}
+
 static void compat_gnutls_dtls_set_mtu(gnutls_session_t session, unsigned int mtu)
 {
     FIXME("\n");
@@ -521,10 +665,14 @@ static NTSTATUS schan_create_session( void *args )
         return STATUS_INTERNAL_ERROR;
     }
     transport->session = s;
+    transport->client = !(flags & GNUTLS_SERVER);
+    transport->protocols = cred->enabled_protocols;
+    if (transport->client) set_session_cert(transport, certificate_creds_from_handle(cred->credentials));
 
     if ((status = set_priority(cred, s)))
     {
         pgnutls_deinit(s);
+        free(transport->cert);
         free(transport);
         return status;
     }
@@ -534,6 +682,7 @@ static NTSTATUS schan_create_session( void *args )
     {
         pgnutls_perror(err);
         pgnutls_deinit(s);
+        free(transport->cert);
         free(transport);
         return STATUS_INTERNAL_ERROR;
     }
@@ -552,8 +701,12 @@ static NTSTATUS schan_dispose_session( void *args )
     const struct session_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
     struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
+    /* TLS 1.3 tickets only arrive after the handshake */
+    if (t->handshake_done) cache_session(t);
     pgnutls_transport_set_ptr(s, NULL);
     pgnutls_deinit(s);
+    free(t->target);
+    free(t->cert);
     free(t);
     return STATUS_SUCCESS;
 }
@@ -562,7 +715,25 @@ static NTSTATUS schan_set_session_target( void *args )
 {
     const struct set_session_target_params *params = args;
     gnutls_session_t s = session_from_handle(params->session);
+    struct schan_transport *t = (struct schan_transport *)pgnutls_transport_get_ptr(s);
+    struct session_cache_entry *entry;
+
     pgnutls_server_name_set( s, GNUTLS_NAME_DNS, params->target, strlen(params->target) );
+    if (!t->client) return STATUS_SUCCESS;
+
+    free(t->target);
+    if (!(t->target = strdup(params->target))) return STATUS_SUCCESS;
+
+    if (!t->cacheable) return STATUS_SUCCESS;
+
+    pthread_mutex_lock(&session_cache_mutex);
+    if ((entry = find_cached_session(t)))
+    {
+        TRACE("Trying to resume session for %s\n", debugstr_a(t->target));
+        pgnutls_session_set_data(s, entry->data, entry->size);
+        if (entry->single_use) free_cached_session(entry);
+    }
+    pthread_mutex_unlock(&session_cache_mutex);
     return STATUS_SUCCESS;
 }
 
@@ -659,6 +830,8 @@ static NTSTATUS schan_handshake( void *args )
         {
             TRACE("Handshake completed\n");
             status = SEC_E_OK;
+            if (!t->handshake_done) cache_session(t);
+            t->handshake_done = TRUE;
         }
         else if (err == GNUTLS_E_AGAIN)
         {
@@ -1520,6 +1693,8 @@ static NTSTATUS process_attach( void *args )
     LOAD_FUNCPTR(gnutls_record_send);
     LOAD_FUNCPTR(gnutls_server_name_set)
     LOAD_FUNCPTR(gnutls_session_channel_binding)
+    LOAD_FUNCPTR(gnutls_session_get_data)
+    LOAD_FUNCPTR(gnutls_session_set_data)
     LOAD_FUNCPTR(gnutls_set_default_priority)
     LOAD_FUNCPTR(gnutls_transport_get_ptr)
     LOAD_FUNCPTR(gnutls_transport_set_errno)
@@ -1562,6 +1737,12 @@ static NTSTATUS process_attach( void *args )
         WARN("gnutls_dtls_set_timeouts not found\n");
         pgnutls_dtls_set_timeouts = compat_gnutls_dtls_set_timeouts;
     }
+    if (!(pgnutls_certificate_get_crt_raw = dlsym(libgnutls_handle, "gnutls_certificate_get_crt_raw")))
+    {
+        WARN("gnutls_certificate_get_crt_raw not found\n");
+        pgnutls_certificate_get_crt_raw = compat_gnutls_certificate_get_crt_raw;
+    }
+
     if (!(pgnutls_privkey_export_x509 = dlsym(libgnutls_handle, "gnutls_privkey_export_x509")))
     {
         WARN("gnutls_privkey_export_x509 not found\n");
@@ -1572,6 +1753,11 @@ static NTSTATUS process_attach( void *args )
         WARN("gnutls_privkey_import_rsa_raw not found\n");
         pgnutls_privkey_import_rsa_raw = compat_gnutls_privkey_import_rsa_raw;
     }
+    if (!(pgnutls_session_get_flags = dlsym(libgnutls_handle, "gnutls_session_get_flags")))
+    {
+        WARN("gnutls_session_get_flags not found\n");
+        pgnutls_session_get_flags = compat_gnutls_session_get_flags;
+    }
 
     ret = pgnutls_global_init();
     if (ret != GNUTLS_E_SUCCESS)
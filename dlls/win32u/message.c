@@ -3524,20 +3524,31 @@ static void wait_message_reply( UINT flags )
 
     for (;;)
     {
-        UINT wake_bits, changed_bits;
+        struct object_lock lock = OBJECT_LOCK_INIT;
+        const queue_shm_t *queue_shm;
+        UINT wake_bits = 0, changed_bits, status;
 
-        if (check_queue_bits( wake_mask, wake_mask, wake_mask, wake_mask,
-                              &wake_bits, &changed_bits ))
-            wake_bits = wake_bits & wake_mask;
-        else SERVER_START_REQ( set_queue_mask )
+        /* the queue masks only matter for waiting, a pending reply or sent
+         * message can be picked up from the shared queue bits directly */
+        while ((status = get_shared_queue( &lock, &queue_shm )) == STATUS_PENDING)
+            wake_bits = queue_shm->wake_bits & wake_mask;
+        if (status) wake_bits = 0;
+
+        if (!wake_bits)
         {
-            req->wake_mask    = wake_mask;
-            req->changed_mask = wake_mask;
-            req->skip_wait    = 1;
-            wine_server_call( req );
-            wake_bits = reply->wake_bits & wake_mask;
+            if (check_queue_bits( wake_mask, wake_mask, wake_mask, wake_mask,
+                                  &wake_bits, &changed_bits ))
+                wake_bits = wake_bits & wake_mask;
+            else SERVER_START_REQ( set_queue_mask )
+            {
+                req->wake_mask    = wake_mask;
+                req->changed_mask = wake_mask;
+                req->skip_wait    = 1;
+                wine_server_call( req );
+                wake_bits = reply->wake_bits & wake_mask;
+            }
+            SERVER_END_REQ;
         }
-        SERVER_END_REQ;
 
         if (wake_bits & QS_SMRESULT) return;  /* got a result */
         if (wake_bits & QS_SENDMESSAGE)
@@ -690,16 +690,45 @@ HWND WINAPI NtUserGetAncestor( HWND hwnd, UINT type )
     return ret;
 }
 
+/* check if a window belongs to the current process and isn't a desktop window */
+static BOOL is_local_child_window( HWND hwnd )
+{
+    WND *win;
+    BOOL ret;
+
+    if (!(win = get_win_ptr( hwnd )) || win == WND_OTHER_PROCESS || win == WND_DESKTOP) return FALSE;
+    ret = win->parent != 0;
+    release_win_ptr( win );
+    return ret;
+}
+
 /* see IsChild */
 BOOL is_child( HWND parent, HWND child )
 {
     HWND *list;
+    WND *win;
     int i;
     BOOL ret = FALSE;
 
+    parent = get_full_window_handle( parent );
+
+    /* walk the parents locally as long as they belong to the current process,
+     * the top of the hierarchy is left to the server */
+    while ((win = get_win_ptr( child )) && win != WND_OTHER_PROCESS && win != WND_DESKTOP)
+    {
+        DWORD style = win->dwStyle;
+        HWND next = win->parent;
+
+        release_win_ptr( win );
+        if (!next) break;
+        if (!(style & WS_CHILD)) return FALSE;
+        if (is_desktop_window( next ) || !is_local_child_window( next )) break;
+        if (next == parent) return TRUE;
+        child = next;
+    }
+
     if (!(get_window_long( child, GWL_STYLE ) & WS_CHILD)) return FALSE;
     if (!(list = list_window_parents( child ))) return FALSE;
-    parent = get_full_window_handle( parent );
     for (i = 0; list[i]; i++)
     {
         if (list[i] == parent)
@@ -718,8 +747,24 @@ BOOL is_window_visible( HWND hwnd )
 {
     HWND *list;
     BOOL retval = TRUE;
+    WND *win;
     int i;
 
+    /* check the parents locally as long as they belong to the current process,
+     * the top of the hierarchy is left to the server */
+    while ((win = get_win_ptr( hwnd )) && win != WND_OTHER_PROCESS && win != WND_DESKTOP)
+    {
+        DWORD style = win->dwStyle;
+        HWND parent = win->parent;
+
+        release_win_ptr( win );
+        if (!parent) break;
+        if (!(style & WS_VISIBLE)) return FALSE;
+        if (is_desktop_window( parent )) return parent == get_desktop_window();
+        if (!is_local_child_window( parent )) break;
+        hwnd = parent;
+    }
+
     if (!(get_window_long( hwnd, GWL_STYLE ) & WS_VISIBLE)) return FALSE;
     if (!(list = list_window_parents( hwnd ))) return TRUE;
     if (list[0])
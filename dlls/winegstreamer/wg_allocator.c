@@ -57,6 +57,10 @@ typedef struct
     struct list memory_list;
 
     struct wg_sample *next_sample;
+
+    /* statistics, in bytes */
+    guint64 unix_allocated;
+    guint64 copied_back;
 } WgAllocator;
 
 typedef struct
@@ -66,10 +70,11 @@ typedef struct
 
 G_DEFINE_TYPE(WgAllocator, wg_allocator, GST_TYPE_ALLOCATOR);
 
-static void *get_unix_memory_data(WgMemory *memory)
+static void *get_unix_memory_data(WgAllocator *allocator, WgMemory *memory)
 {
     if (!memory->unix_memory)
     {
+        allocator->unix_allocated += memory->parent.maxsize;
         memory->unix_memory = gst_allocator_alloc(NULL, memory->parent.maxsize, &memory->alloc_params);
         gst_memory_map(memory->unix_memory, &memory->unix_map_info, GST_MAP_WRITE);
         GST_INFO("Allocated unix memory %p, data %p for memory %p, sample %p", memory->unix_memory,
@@ -96,7 +101,8 @@ static void release_memory_sample(WgAllocator *allocator, WgMemory *memory, bool
     if (memory->written && !discard_data)
     {
         GST_WARNING("Copying %#zx bytes from sample %p, back to memory %p", memory->written, sample, memory);
-        memcpy(get_unix_memory_data(memory), wg_sample_data(memory->sample), memory->written);
+        memcpy(get_unix_memory_data(allocator, memory), wg_sample_data(memory->sample), memory->written);
+        allocator->copied_back += memory->written;
     }
 
     memory->sample = NULL;
@@ -116,7 +122,7 @@ static gpointer wg_allocator_map(GstMemory *gst_memory, GstMapInfo *info, gsize
     pthread_mutex_lock(&allocator->mutex);
 
     if (!memory->sample)
-        info->data = get_unix_memory_data(memory);
+        info->data = get_unix_memory_data(allocator, memory);
     else
     {
         InterlockedIncrement(&memory->sample->refcount);
@@ -268,6 +274,9 @@ void wg_allocator_destroy(GstAllocator *gst_allocator)
         release_memory_sample(allocator, memory, true);
     pthread_mutex_unlock(&allocator->mutex);
 
+    GST_INFO("allocator %p allocated %"G_GUINT64_FORMAT" bytes of unix memory, copied back %"G_GUINT64_FORMAT" bytes",
+            allocator, allocator->unix_allocated, allocator->copied_back);
+
     g_object_unref(allocator);
 
     GST_INFO("Destroyed buffer allocator %p", allocator);
@@ -96,6 +96,11 @@ struct wg_transform
     GstCaps *input_caps;
 
     bool draining;
+
+    /* statistics, in bytes */
+    guint64 input_aliased;
+    guint64 output_aliased;
+    guint64 output_copied;
 };
 
 static struct wg_transform *get_transform(wg_transform_t trans)
@@ -447,6 +452,10 @@ NTSTATUS wg_transform_destroy(void *args)
     GstSample *sample;
     GstBuffer *buffer;
 
+    GST_INFO("transform %p aliased %"G_GUINT64_FORMAT" input bytes, aliased %"G_GUINT64_FORMAT
+            " and copied %"G_GUINT64_FORMAT" output bytes", transform, transform->input_aliased,
+            transform->output_aliased, transform->output_copied);
+
     while ((buffer = gst_atomic_queue_pop(transform->input_queue)))
         gst_buffer_unref(buffer);
     gst_atomic_queue_unref(transform->input_queue);
@@ -988,8 +997,8 @@ static bool sample_needs_buffer_copy(struct wg_sample *sample, GstBuffer *buffer
     return needs_copy;
 }
 
-static NTSTATUS read_transform_output_video(struct wg_sample *sample, GstBuffer *buffer,
-        GstVideoInfo *src_video_info, GstVideoInfo *dst_video_info)
+static NTSTATUS read_transform_output_video(struct wg_transform *transform, struct wg_sample *sample,
+        GstBuffer *buffer, GstVideoInfo *src_video_info, GstVideoInfo *dst_video_info)
 {
     gsize total_size;
     NTSTATUS status;
@@ -1010,16 +1019,24 @@ static NTSTATUS read_transform_output_video(struct wg_sample *sample, GstBuffer
     set_sample_flags_from_buffer(sample, buffer, total_size);
 
     if (needs_copy)
+    {
+        transform->output_copied += sample->size;
         GST_WARNING("Copied %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
-    else if (sample->flags & WG_SAMPLE_FLAG_INCOMPLETE)
-        GST_ERROR("Partial read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    }
     else
-        GST_INFO("Read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    {
+        transform->output_aliased += sample->size;
+        if (sample->flags & WG_SAMPLE_FLAG_INCOMPLETE)
+            GST_ERROR("Partial read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+        else
+            GST_INFO("Read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    }
 
     return STATUS_SUCCESS;
 }
 
-static NTSTATUS read_transform_output(struct wg_sample *sample, GstBuffer *buffer)
+static NTSTATUS read_transform_output(struct wg_transform *transform, struct wg_sample *sample,
+        GstBuffer *buffer)
 {
     gsize total_size;
     NTSTATUS status;
@@ -1040,11 +1057,18 @@ static NTSTATUS read_transform_output(struct wg_sample *sample, GstBuffer *buffe
     set_sample_flags_from_buffer(sample, buffer, total_size);
 
     if (needs_copy)
+    {
+        transform->output_copied += sample->size;
         GST_INFO("Copied %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
-    else if (sample->flags & WG_SAMPLE_FLAG_INCOMPLETE)
-        GST_ERROR("Partial read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    }
     else
-        GST_INFO("Read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    {
+        transform->output_aliased += sample->size;
+        if (sample->flags & WG_SAMPLE_FLAG_INCOMPLETE)
+            GST_ERROR("Partial read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+        else
+            GST_INFO("Read %u bytes, sample %p, flags %#x", sample->size, sample, sample->flags);
+    }
 
     return STATUS_SUCCESS;
 }
@@ -1096,6 +1120,8 @@ static bool get_transform_output(struct wg_transform *transform, struct wg_sampl
         if (!(input_buffer = gst_atomic_queue_pop(transform->input_queue)))
             break;
 
+        /* input buffers wrap the sample memory, count what actually reaches the pipeline */
+        transform->input_aliased += gst_buffer_get_size(input_buffer);
         if ((ret = gst_pad_push(transform->my_src, input_buffer)))
             GST_WARNING("Failed to push transform input, error %d", ret);
 
@@ -1164,10 +1190,10 @@ NTSTATUS wg_transform_read_data(void *args)
     }
 
     if (!strcmp(output_mime, "video/x-raw"))
-        status = read_transform_output_video(sample, output_buffer,
+        status = read_transform_output_video(transform, sample, output_buffer,
                 &src_video_info, &dst_video_info);
     else
-        status = read_transform_output(sample, output_buffer);
+        status = read_transform_output(transform, sample, output_buffer);
 
     if (status)
     {
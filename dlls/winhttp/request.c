@@ -42,6 +42,7 @@
 WINE_DEFAULT_DEBUG_CHANNEL(winhttp);
 
 #define DEFAULT_KEEP_ALIVE_TIMEOUT 30000
+#define DEFAULT_RESOLVE_CACHE_TIMEOUT 60000
 
 #define ACTUAL_DEFAULT_RECEIVE_RESPONSE_TIMEOUT 21000
 
@@ -1440,7 +1441,24 @@ static CRITICAL_SECTION_DEBUG connection_pool_debug =
 };
 static CRITICAL_SECTION connection_pool_cs = { &connection_pool_debug, -1, 0, 0, 0, 0 };
 
-static struct list connection_pool = LIST_INIT( connection_pool );
+/* hosts are hashed by name and port, so that looking up a host doesn't walk
+ * every host the process ever connected to */
+#define CONNECTION_POOL_BUCKETS 64
+static struct list connection_pool[CONNECTION_POOL_BUCKETS];
+
+/* must be called with connection_pool_cs held */
+static struct list *get_connection_pool_bucket( const WCHAR *hostname, INTERNET_PORT port )
+{
+    unsigned int i, hash = port;
+
+    if (!connection_pool[0].next)
+    {
+        for (i = 0; i < CONNECTION_POOL_BUCKETS; i++) list_init( &connection_pool[i] );
+    }
+
+    while (*hostname) hash = hash * 31 + *hostname++;
+    return &connection_pool[hash % CONNECTION_POOL_BUCKETS];
+}
 
 void release_host( struct hostdata *host )
 {
@@ -1464,6 +1482,7 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
     struct netconn *netconn, *next_netconn;
     struct hostdata *host, *next_host;
     ULONGLONG now;
+    unsigned int i;
 
     do
     {
@@ -1474,17 +1493,20 @@ static void CALLBACK connection_collector( TP_CALLBACK_INSTANCE *instance, void
 
         EnterCriticalSection(&connection_pool_cs);
 
-        LIST_FOR_EACH_ENTRY_SAFE(host, next_host, &connection_pool, struct hostdata, entry)
+        for (i = 0; i < CONNECTION_POOL_BUCKETS; i++)
         {
-            LIST_FOR_EACH_ENTRY_SAFE(netconn, next_netconn, &host->connections, struct netconn, entry)
+            LIST_FOR_EACH_ENTRY_SAFE(host, next_host, &connection_pool[i], struct hostdata, entry)
             {
-                if (netconn->keep_until < now)
+                LIST_FOR_EACH_ENTRY_SAFE(netconn, next_netconn, &host->connections, struct netconn, entry)
                 {
-                    TRACE("freeing %p\n", netconn);
-                    list_remove(&netconn->entry);
-                    netconn_release(netconn);
+                    if (netconn->keep_until < now)
+                    {
+                        TRACE("freeing %p\n", netconn);
+                        list_remove(&netconn->entry);
+                        netconn_release(netconn);
+                    }
+                    else remaining_connections++;
                 }
-                else remaining_connections++;
             }
         }
 
@@ -1566,6 +1588,7 @@ static DWORD open_connection( struct request *request )
     struct hostdata *host = NULL, *iter;
     struct netconn *netconn = NULL;
     struct connect *connect;
+    struct list *bucket;
     WCHAR *addressW = NULL;
     INTERNET_PORT port;
     DWORD ret, len;
@@ -1577,7 +1600,8 @@ static DWORD open_connection( struct request *request )
 
     EnterCriticalSection( &connection_pool_cs );
 
-    LIST_FOR_EACH_ENTRY( iter, &connection_pool, struct hostdata, entry )
+    bucket = get_connection_pool_bucket( connect->servername, port );
+    LIST_FOR_EACH_ENTRY( iter, bucket, struct hostdata, entry )
     {
         if (iter->port == port && !wcscmp( connect->servername, iter->hostname ) && !is_secure == !iter->secure)
         {
@@ -1594,10 +1618,11 @@ static DWORD open_connection( struct request *request )
             host->ref = 1;
             host->secure = is_secure;
             host->port = port;
+            host->resolved_until = 0;
             list_init( &host->connections );
             if ((host->hostname = wcsdup( connect->servername )))
             {
-                list_add_head( &connection_pool, &host->entry );
+                list_add_head( bucket, &host->entry );
             }
             else
             {
@@ -1639,12 +1664,29 @@ static DWORD open_connection( struct request *request )
         len = lstrlenW( host->hostname ) + 1;
         send_callback( &request->hdr, WINHTTP_CALLBACK_STATUS_RESOLVING_NAME, host->hostname, len );
 
-        if ((ret = netconn_resolve( host->hostname, port, &connect->sockaddr, request->resolve_timeout )))
+        /* reuse the address another connect handle resolved for this host */
+        EnterCriticalSection( &connection_pool_cs );
+        if (host->resolved_until > GetTickCount64())
         {
-            release_host( host );
-            return ret;
+            connect->sockaddr = host->sockaddr;
+            connect->resolved = TRUE;
+        }
+        LeaveCriticalSection( &connection_pool_cs );
+
+        if (!connect->resolved)
+        {
+            if ((ret = netconn_resolve( host->hostname, port, &connect->sockaddr, request->resolve_timeout )))
+            {
+                release_host( host );
+                return ret;
+            }
+            connect->resolved = TRUE;
+
+            EnterCriticalSection( &connection_pool_cs );
+            host->sockaddr = connect->sockaddr;
+            host->resolved_until = GetTickCount64() + DEFAULT_RESOLVE_CACHE_TIMEOUT;
+            LeaveCriticalSection( &connection_pool_cs );
         }
-        connect->resolved = TRUE;
 
         if (!(addressW = addr_to_str( &connect->sockaddr )))
         {
@@ -1670,6 +1712,10 @@ static DWORD open_connection( struct request *request )
 
         if ((ret = netconn_create( host, &connect->sockaddr, request->connect_timeout, &netconn )))
         {
+            /* don't hand the unreachable address to other connect handles */
+            EnterCriticalSection( &connection_pool_cs );
+            if (!memcmp( &host->sockaddr, &connect->sockaddr, sizeof(host->sockaddr) )) host->resolved_until = 0;
+            LeaveCriticalSection( &connection_pool_cs );
             free( addressW );
             release_host( host );
             return ret;
@@ -64,6 +64,8 @@ struct hostdata
     INTERNET_PORT port;
     BOOL secure;
     struct list connections;
+    struct sockaddr_storage sockaddr; /* last resolved address */
+    ULONGLONG resolved_until;
 };
 
 struct session
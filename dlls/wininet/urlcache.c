@@ -275,14 +275,28 @@ static inline void urlcache_block_alloc(BYTE *allocation_table, DWORD block_numb
  */
 static DWORD urlcache_entry_alloc(urlcache_header *header, DWORD blocks_needed, entry_header **entry)
 {
-    DWORD block, block_size;
+    BYTE *table = header->allocation_table;
+    DWORD block, block_size, next;
 
     for(block=0; block<header->capacity_in_blocks; block+=block_size+1)
     {
+        /* skip over fully allocated bytes of the table at once */
+        while(!(block%CHAR_BIT) && block+CHAR_BIT<=header->capacity_in_blocks
+                && table[block/CHAR_BIT]==0xff)
+            block += CHAR_BIT;
+
         block_size = 0;
-        while(block_size<blocks_needed && block_size+block<header->capacity_in_blocks
-                && urlcache_block_is_free(header->allocation_table, block+block_size))
-            block_size++;
+        while(block_size<blocks_needed && block_size+block<header->capacity_in_blocks)
+        {
+            next = block+block_size;
+            if(!(next%CHAR_BIT) && blocks_needed-block_size>=CHAR_BIT
+                    && next+CHAR_BIT<=header->capacity_in_blocks && !table[next/CHAR_BIT])
+                block_size += CHAR_BIT;
+            else if(urlcache_block_is_free(table, next))
+                block_size++;
+            else
+                break;
+        }
 
         if(block_size == blocks_needed)
         {
@@ -312,6 +312,13 @@ static inline const char *debugstr_sockopt(int level, int optname)
         }
         break;
 
+        DEBUG_SOCKLEVEL(IPPROTO_UDP);
+        switch(optname)
+        {
+            DEBUG_SOCKOPT(UDP_SEND_MSG_SIZE);
+        }
+        break;
+
         DEBUG_SOCKLEVEL(IPPROTO_IP);
         switch(optname)
         {
@@ -1106,6 +1113,759 @@ static int WINAPI WS2_WSARecvMsg( SOCKET s, LPWSAMSG msg, LPDWORD lpNumberOfByte
 }
 
 
+/* Registered I/O is implemented on top of the regular overlapped requests.
+ * Each request queue preallocates its requests, and each request completes
+ * through its own event, tagged so that no packet is queued to a completion
+ * port the application may have associated with the socket. A thread pool
+ * wait on that event moves the completion into a user space ring, which the
+ * application polls with RIODequeueCompletion(). */
+
+struct rio_buffer
+{
+    char *data;
+    DWORD len;
+};
+
+struct rio_cq
+{
+    CRITICAL_SECTION cs;
+    RIO_NOTIFICATION_COMPLETION notify;
+    BOOL has_notify;
+    BOOL notify_armed;
+    BOOL corrupt;
+    RIORESULT *results;
+    DWORD size;
+    DWORD head;
+    DWORD count;
+    DWORD reserved;
+};
+
+struct rio_request
+{
+    OVERLAPPED ovl;
+    struct list entry;
+    struct rio_rq *rq;
+    HANDLE event;
+    TP_WAIT *wait;
+    BOOL submitted;
+    BOOL send;
+    BOOL notify;
+    ULONGLONG context;
+    WSABUF data;
+    WSABUF control;
+    DWORD flags;
+    int addr_len;
+    DWORD *flags_out;
+};
+
+struct rio_request_block
+{
+    struct rio_request *requests;
+    ULONG count;
+};
+
+struct rio_rq
+{
+    struct rio_rq *next;
+    CRITICAL_SECTION cs;
+    SOCKET socket;
+    HANDLE drained;
+    BOOL closing;
+    struct rio_cq *recv_cq;
+    struct rio_cq *send_cq;
+    ULONGLONG context;
+    ULONG max_recv;
+    ULONG max_send;
+    ULONG recv_pending;
+    ULONG send_pending;
+    ULONG capacity;
+    struct list free_requests;
+    struct rio_request_block *blocks;
+    unsigned int block_count;
+};
+
+static struct rio_rq *rio_queues;
+
+static CRITICAL_SECTION rio_cs;
+static CRITICAL_SECTION_DEBUG rio_cs_debug =
+{
+    0, 0, &rio_cs,
+    { &rio_cs_debug.ProcessLocksList, &rio_cs_debug.ProcessLocksList },
+      0, 0, { (DWORD_PTR)(__FILE__ ": rio_cs") }
+};
+static CRITICAL_SECTION rio_cs = { &rio_cs_debug, -1, 0, 0, 0, 0 };
+
+static char *rio_buffer_ptr( const RIO_BUF *buf, ULONG min_len )
+{
+    struct rio_buffer *buffer;
+
+    if (!buf || !buf->BufferId || buf->BufferId == RIO_INVALID_BUFFERID) return NULL;
+    buffer = (struct rio_buffer *)buf->BufferId;
+    if (buf->Offset > buffer->len || buf->Length > buffer->len - buf->Offset) return NULL;
+    if (buf->Length < min_len) return NULL;
+    return buffer->data + buf->Offset;
+}
+
+static void rio_cq_notify( struct rio_cq *cq )
+{
+    cq->notify_armed = FALSE;
+    if (cq->notify.Type == RIO_EVENT_COMPLETION)
+        SetEvent( cq->notify.Event.EventHandle );
+    else
+        PostQueuedCompletionStatus( cq->notify.Iocp.IocpHandle, 0, (ULONG_PTR)cq->notify.Iocp.CompletionKey,
+                                    cq->notify.Iocp.Overlapped );
+}
+
+static void rio_cq_push( struct rio_cq *cq, struct rio_rq *rq, struct rio_request *request, NTSTATUS status )
+{
+    RIORESULT *res;
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->count == cq->size)
+    {
+        WARN( "completion queue %p overflow\n", cq );
+        cq->corrupt = TRUE;
+    }
+    else
+    {
+        res = &cq->results[(cq->head + cq->count++) % cq->size];
+        res->Status = NtStatusToWSAError( status );
+        res->BytesTransferred = request->ovl.InternalHigh;
+        res->SocketContext = rq->context;
+        res->RequestContext = request->context;
+    }
+    if (cq->notify_armed && request->notify) rio_cq_notify( cq );
+    LeaveCriticalSection( &cq->cs );
+}
+
+/* rq->cs must be held by caller */
+static void rio_request_release( struct rio_rq *rq, struct rio_request *request )
+{
+    request->submitted = FALSE;
+    list_add_head( &rq->free_requests, &request->entry );
+    if (request->send) rq->send_pending--;
+    else rq->recv_pending--;
+    if (rq->closing && !rq->recv_pending && !rq->send_pending) SetEvent( rq->drained );
+}
+
+/* move a request to its completion queue if it has completed, rq->cs must be held by caller */
+static BOOL rio_request_complete( struct rio_rq *rq, struct rio_request *request )
+{
+    NTSTATUS status = ReadAcquire( (LONG *)&request->ovl.Internal );
+
+    if (status == STATUS_PENDING) return FALSE;
+
+    TRACE( "rq %p, request %p, status %#lx, bytes %Iu\n", rq, request, status, request->ovl.InternalHigh );
+
+    if (request->flags_out) *request->flags_out = request->flags;
+    rio_cq_push( request->send ? rq->send_cq : rq->recv_cq, rq, request, status );
+    rio_request_release( rq, request );
+    return TRUE;
+}
+
+static void CALLBACK rio_request_callback( TP_CALLBACK_INSTANCE *instance, void *context,
+                                           TP_WAIT *wait, TP_WAIT_RESULT result )
+{
+    struct rio_request *request = context;
+    struct rio_rq *rq = request->rq;
+
+    EnterCriticalSection( &rq->cs );
+    /* the event may also be left signaled by a request which completed synchronously */
+    if (request->submitted && !rio_request_complete( rq, request ))
+        SetThreadpoolWait( wait, request->event, NULL );
+    LeaveCriticalSection( &rq->cs );
+}
+
+/* rq->cs must be held by caller */
+static BOOL rio_rq_grow( struct rio_rq *rq, ULONG capacity )
+{
+    struct rio_request_block *blocks;
+    struct rio_request *requests;
+    ULONG i, count;
+
+    if (capacity <= rq->capacity) return TRUE;
+    count = capacity - rq->capacity;
+
+    if (!(blocks = realloc( rq->blocks, (rq->block_count + 1) * sizeof(*blocks) ))) return FALSE;
+    rq->blocks = blocks;
+    if (!(requests = calloc( count, sizeof(*requests) ))) return FALSE;
+
+    for (i = 0; i < count; ++i)
+    {
+        requests[i].rq = rq;
+        if (!(requests[i].event = CreateEventW( NULL, FALSE, FALSE, NULL ))) break;
+        if (!(requests[i].wait = CreateThreadpoolWait( rio_request_callback, &requests[i], NULL )))
+        {
+            CloseHandle( requests[i].event );
+            break;
+        }
+    }
+    if (i < count)
+    {
+        while (i--)
+        {
+            CloseThreadpoolWait( requests[i].wait );
+            CloseHandle( requests[i].event );
+        }
+        free( requests );
+        return FALSE;
+    }
+
+    for (i = 0; i < count; ++i) list_add_tail( &rq->free_requests, &requests[i].entry );
+    rq->blocks[rq->block_count].requests = requests;
+    rq->blocks[rq->block_count++].count = count;
+    rq->capacity = capacity;
+    return TRUE;
+}
+
+static void rio_rq_destroy( struct rio_rq *rq )
+{
+    unsigned int i;
+    ULONG j;
+
+    for (i = 0; i < rq->block_count; ++i)
+    {
+        for (j = 0; j < rq->blocks[i].count; ++j)
+        {
+            struct rio_request *request = &rq->blocks[i].requests[j];
+
+            SetThreadpoolWait( request->wait, NULL, NULL );
+            WaitForThreadpoolWaitCallbacks( request->wait, TRUE );
+            CloseThreadpoolWait( request->wait );
+            CloseHandle( request->event );
+        }
+        free( rq->blocks[i].requests );
+    }
+    free( rq->blocks );
+    if (rq->drained) CloseHandle( rq->drained );
+    rq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &rq->cs );
+    free( rq );
+}
+
+static struct rio_request *rio_request_get( struct rio_rq *rq, BOOL send, DWORD flags, void *context )
+{
+    struct rio_request *request;
+
+    EnterCriticalSection( &rq->cs );
+    if (send ? rq->send_pending >= rq->max_send : rq->recv_pending >= rq->max_recv)
+    {
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( WSAENOBUFS );
+        return NULL;
+    }
+    request = LIST_ENTRY( list_head( &rq->free_requests ), struct rio_request, entry );
+    list_remove( &request->entry );
+    if (send) rq->send_pending++;
+    else rq->recv_pending++;
+    LeaveCriticalSection( &rq->cs );
+
+    memset( &request->ovl, 0, sizeof(request->ovl) );
+    request->ovl.Internal = STATUS_PENDING;
+    /* don't queue the completion to a port associated with the socket */
+    request->ovl.hEvent = (HANDLE)((ULONG_PTR)request->event | 1);
+    request->send = send;
+    request->notify = !(flags & RIO_MSG_DONT_NOTIFY);
+    request->context = (ULONG_PTR)context;
+    ResetEvent( request->event );
+    return request;
+}
+
+static BOOL rio_request_submit( struct rio_rq *rq, struct rio_request *request, int ret )
+{
+    DWORD err = GetLastError();
+
+    EnterCriticalSection( &rq->cs );
+    if (ret && err != WSA_IO_PENDING)
+    {
+        rio_request_release( rq, request );
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( err );
+        return FALSE;
+    }
+    request->submitted = TRUE;
+    if (!rio_request_complete( rq, request ))
+        SetThreadpoolWait( request->wait, request->event, NULL );
+    LeaveCriticalSection( &rq->cs );
+    return TRUE;
+}
+
+static void rio_close_socket( SOCKET s )
+{
+    struct rio_rq *rq, **prev;
+    BOOL drained;
+
+    EnterCriticalSection( &rio_cs );
+    for (prev = &rio_queues; (rq = *prev); prev = &rq->next)
+    {
+        if (rq->socket != s) continue;
+        *prev = rq->next;
+        break;
+    }
+    LeaveCriticalSection( &rio_cs );
+
+    if (!rq) return;
+
+    /* the pending requests complete with STATUS_CANCELLED, wait for their callbacks */
+    CancelIoEx( (HANDLE)s, NULL );
+    EnterCriticalSection( &rq->cs );
+    rq->closing = TRUE;
+    drained = !rq->recv_pending && !rq->send_pending;
+    LeaveCriticalSection( &rq->cs );
+    if (!drained) WaitForSingleObject( rq->drained, INFINITE );
+
+    EnterCriticalSection( &rq->recv_cq->cs );
+    rq->recv_cq->reserved -= rq->max_recv;
+    LeaveCriticalSection( &rq->recv_cq->cs );
+    EnterCriticalSection( &rq->send_cq->cs );
+    rq->send_cq->reserved -= rq->max_send;
+    LeaveCriticalSection( &rq->send_cq->cs );
+    rio_rq_destroy( rq );
+}
+
+static BOOL rio_cq_reserve( struct rio_cq *cq, LONG count )
+{
+    BOOL ret;
+
+    EnterCriticalSection( &cq->cs );
+    if ((ret = count <= 0 || cq->size - cq->reserved >= count)) cq->reserved += count;
+    LeaveCriticalSection( &cq->cs );
+    return ret;
+}
+
+/***********************************************************************
+ *     RIORegisterBuffer
+ */
+static RIO_BUFFERID WINAPI WS2_RIORegisterBuffer( char *data, DWORD len )
+{
+    struct rio_buffer *buffer;
+
+    TRACE( "data %p, len %lu\n", data, len );
+
+    if (!data || !len)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_BUFFERID;
+    }
+    if (!(buffer = malloc( sizeof(*buffer) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_BUFFERID;
+    }
+    buffer->data = data;
+    buffer->len = len;
+    return (RIO_BUFFERID)buffer;
+}
+
+/***********************************************************************
+ *     RIODeregisterBuffer
+ */
+static void WINAPI WS2_RIODeregisterBuffer( RIO_BUFFERID id )
+{
+    TRACE( "id %p\n", id );
+
+    if (id == RIO_INVALID_BUFFERID) return;
+    free( id );
+}
+
+/***********************************************************************
+ *     RIOCreateCompletionQueue
+ */
+static RIO_CQ WINAPI WS2_RIOCreateCompletionQueue( DWORD size, RIO_NOTIFICATION_COMPLETION *notify )
+{
+    struct rio_cq *cq;
+
+    TRACE( "size %lu, notify %p\n", size, notify );
+
+    if (!size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+    if (notify && !(notify->Type == RIO_EVENT_COMPLETION && notify->Event.EventHandle)
+               && !(notify->Type == RIO_IOCP_COMPLETION && notify->Iocp.IocpHandle))
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_CQ;
+    }
+
+    if (!(cq = calloc( 1, sizeof(*cq) )) || !(cq->results = malloc( size * sizeof(*cq->results) )))
+    {
+        free( cq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_CQ;
+    }
+    InitializeCriticalSection( &cq->cs );
+    cq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_cq.cs");
+    if (notify)
+    {
+        cq->notify = *notify;
+        cq->has_notify = TRUE;
+    }
+    cq->size = size;
+    return (RIO_CQ)cq;
+}
+
+/***********************************************************************
+ *     RIOCloseCompletionQueue
+ */
+static void WINAPI WS2_RIOCloseCompletionQueue( RIO_CQ handle )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+
+    TRACE( "cq %p\n", cq );
+
+    if (!cq) return;
+    cq->cs.DebugInfo->Spare[0] = 0;
+    DeleteCriticalSection( &cq->cs );
+    free( cq->results );
+    free( cq );
+}
+
+/***********************************************************************
+ *     RIOResizeCompletionQueue
+ */
+static BOOL WINAPI WS2_RIOResizeCompletionQueue( RIO_CQ handle, DWORD size )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+    RIORESULT *results;
+    DWORD i;
+
+    TRACE( "cq %p, size %lu\n", cq, size );
+
+    if (!cq || !size || size > RIO_MAX_CQ_SIZE)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if (size < cq->count || size < cq->reserved)
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (!(results = malloc( size * sizeof(*results) )))
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    for (i = 0; i < cq->count; ++i) results[i] = cq->results[(cq->head + i) % cq->size];
+    free( cq->results );
+    cq->results = results;
+    cq->head = 0;
+    cq->size = size;
+    LeaveCriticalSection( &cq->cs );
+    return TRUE;
+}
+
+/***********************************************************************
+ *     RIODequeueCompletion
+ */
+static ULONG WINAPI WS2_RIODequeueCompletion( RIO_CQ handle, RIORESULT *results, ULONG count )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+    ULONG i;
+
+    TRACE( "cq %p, results %p, count %lu\n", cq, results, count );
+
+    if (!cq || !results || !count)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_CORRUPT_CQ;
+    }
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->corrupt)
+    {
+        LeaveCriticalSection( &cq->cs );
+        SetLastError( WSAEINVAL );
+        return RIO_CORRUPT_CQ;
+    }
+    count = min( count, cq->count );
+    for (i = 0; i < count; ++i) results[i] = cq->results[(cq->head + i) % cq->size];
+    cq->head = (cq->head + count) % cq->size;
+    cq->count -= count;
+    LeaveCriticalSection( &cq->cs );
+    return count;
+}
+
+/***********************************************************************
+ *     RIONotify
+ */
+static int WINAPI WS2_RIONotify( RIO_CQ handle )
+{
+    struct rio_cq *cq = (struct rio_cq *)handle;
+    int ret = ERROR_SUCCESS;
+
+    TRACE( "cq %p\n", cq );
+
+    if (!cq || !cq->has_notify) return WSAEINVAL;
+
+    EnterCriticalSection( &cq->cs );
+    if (cq->notify_armed) ret = WSAEALREADY;
+    else
+    {
+        if (cq->notify.Type == RIO_EVENT_COMPLETION && cq->notify.Event.NotifyReset)
+            ResetEvent( cq->notify.Event.EventHandle );
+        cq->notify_armed = TRUE;
+        if (cq->count) rio_cq_notify( cq );
+    }
+    LeaveCriticalSection( &cq->cs );
+    return ret;
+}
+
+/***********************************************************************
+ *     RIOCreateRequestQueue
+ */
+static RIO_RQ WINAPI WS2_RIOCreateRequestQueue( SOCKET s, ULONG max_recv, ULONG max_recv_buffers,
+                                                ULONG max_send, ULONG max_send_buffers,
+                                                RIO_CQ recv_cq, RIO_CQ send_cq, void *context )
+{
+    struct rio_rq *rq, *iter;
+
+    TRACE( "socket %#Ix, max_recv %lu, max_recv_buffers %lu, max_send %lu, max_send_buffers %lu, "
+           "recv_cq %p, send_cq %p, context %p\n", s, max_recv, max_recv_buffers, max_send,
+           max_send_buffers, recv_cq, send_cq, context );
+
+    if (!socket_list_find( s ))
+    {
+        SetLastError( WSAENOTSOCK );
+        return RIO_INVALID_RQ;
+    }
+    if (!recv_cq || !send_cq || max_recv_buffers > 1 || max_send_buffers > 1
+            || max_recv > INT_MAX || max_send > INT_MAX)
+    {
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+
+    if (!(rq = calloc( 1, sizeof(*rq) )))
+    {
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    InitializeCriticalSection( &rq->cs );
+    rq->cs.DebugInfo->Spare[0] = (DWORD_PTR)(__FILE__ ": rio_rq.cs");
+    list_init( &rq->free_requests );
+    rq->socket = s;
+    rq->recv_cq = (struct rio_cq *)recv_cq;
+    rq->send_cq = (struct rio_cq *)send_cq;
+    rq->context = (ULONG_PTR)context;
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+
+    if (!(rq->drained = CreateEventW( NULL, TRUE, FALSE, NULL )) || !rio_rq_grow( rq, max_recv + max_send ))
+    {
+        rio_rq_destroy( rq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    if (!rio_cq_reserve( rq->recv_cq, rq->max_recv ))
+    {
+        rio_rq_destroy( rq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+    if (!rio_cq_reserve( rq->send_cq, rq->max_send ))
+    {
+        rio_cq_reserve( rq->recv_cq, -rq->max_recv );
+        rio_rq_destroy( rq );
+        SetLastError( WSAENOBUFS );
+        return RIO_INVALID_RQ;
+    }
+
+    EnterCriticalSection( &rio_cs );
+    for (iter = rio_queues; iter; iter = iter->next)
+        if (iter->socket == s) break;
+    if (!iter)
+    {
+        rq->next = rio_queues;
+        rio_queues = rq;
+    }
+    LeaveCriticalSection( &rio_cs );
+
+    if (iter)
+    {
+        WARN( "socket %#Ix already has a request queue\n", s );
+        rio_cq_reserve( rq->recv_cq, -rq->max_recv );
+        rio_cq_reserve( rq->send_cq, -rq->max_send );
+        rio_rq_destroy( rq );
+        SetLastError( WSAEINVAL );
+        return RIO_INVALID_RQ;
+    }
+    return (RIO_RQ)rq;
+}
+
+/***********************************************************************
+ *     RIOResizeRequestQueue
+ */
+static BOOL WINAPI WS2_RIOResizeRequestQueue( RIO_RQ handle, DWORD max_recv, DWORD max_send )
+{
+    struct rio_rq *rq = (struct rio_rq *)handle;
+
+    TRACE( "rq %p, max_recv %lu, max_send %lu\n", rq, max_recv, max_send );
+
+    if (!rq || max_recv > INT_MAX || max_send > INT_MAX)
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+
+    EnterCriticalSection( &rq->cs );
+    if (!rio_rq_grow( rq, max_recv + max_send ))
+    {
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    if (!rio_cq_reserve( rq->recv_cq, (LONG)max_recv - rq->max_recv ))
+    {
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    if (!rio_cq_reserve( rq->send_cq, (LONG)max_send - rq->max_send ))
+    {
+        rio_cq_reserve( rq->recv_cq, rq->max_recv - (LONG)max_recv );
+        LeaveCriticalSection( &rq->cs );
+        SetLastError( WSAENOBUFS );
+        return FALSE;
+    }
+    rq->max_recv = max_recv;
+    rq->max_send = max_send;
+    LeaveCriticalSection( &rq->cs );
+    return TRUE;
+}
+
+/***********************************************************************
+ *     RIOReceiveEx
+ */
+static int WINAPI WS2_RIOReceiveEx( RIO_RQ handle, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                    RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *flags_buf,
+                                    DWORD flags, void *context )
+{
+    struct rio_rq *rq = (struct rio_rq *)handle;
+    WSABUF buffer = {0}, control_buffer = {0};
+    struct sockaddr *addr = NULL;
+    struct rio_request *request;
+    DWORD *flags_out = NULL;
+
+    TRACE( "rq %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, flags_buf %p, "
+           "flags %#lx, context %p\n", rq, data, count, local_addr, remote_addr, control,
+           flags_buf, flags, context );
+
+    if (!rq || count > 1 || (count && !data) || (flags & ~(RIO_MSG_DONT_NOTIFY | RIO_MSG_DEFER
+            | RIO_MSG_WAITALL | RIO_MSG_COMMIT_ONLY)))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    /* requests are never deferred, so there is nothing left to commit */
+    if (flags & RIO_MSG_COMMIT_ONLY) return TRUE;
+
+    if (local_addr) FIXME( "local address not supported\n" );
+
+    if (count)
+    {
+        if (!(buffer.buf = rio_buffer_ptr( data, 0 ))) goto invalid;
+        buffer.len = data->Length;
+    }
+    if (remote_addr && !(addr = (struct sockaddr *)rio_buffer_ptr( remote_addr, sizeof(SOCKADDR_INET) )))
+        goto invalid;
+    if (control)
+    {
+        if (!(control_buffer.buf = rio_buffer_ptr( control, 0 ))) goto invalid;
+        control_buffer.len = control->Length;
+    }
+    if (flags_buf && !(flags_out = (DWORD *)rio_buffer_ptr( flags_buf, sizeof(DWORD) ))) goto invalid;
+
+    if (!(request = rio_request_get( rq, FALSE, flags, context ))) return FALSE;
+    request->data = buffer;
+    request->control = control_buffer;
+    request->addr_len = addr ? sizeof(SOCKADDR_INET) : 0;
+    request->flags = flags & RIO_MSG_WAITALL ? MSG_WAITALL : 0;
+    request->flags_out = flags_out;
+
+    return rio_request_submit( rq, request, WS2_recv_base( rq->socket, &request->data, 1, NULL, &request->flags,
+                                                           addr, addr ? &request->addr_len : NULL, &request->ovl,
+                                                           NULL, control ? &request->control : NULL ) );
+
+invalid:
+    SetLastError( WSAEINVAL );
+    return FALSE;
+}
+
+/***********************************************************************
+ *     RIOReceive
+ */
+static BOOL WINAPI WS2_RIOReceive( RIO_RQ rq, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    return WS2_RIOReceiveEx( rq, data, count, NULL, NULL, NULL, NULL, flags, context );
+}
+
+/***********************************************************************
+ *     RIOSendEx
+ */
+static BOOL WINAPI WS2_RIOSendEx( RIO_RQ handle, RIO_BUF *data, ULONG count, RIO_BUF *local_addr,
+                                  RIO_BUF *remote_addr, RIO_BUF *control, RIO_BUF *flags_buf,
+                                  DWORD flags, void *context )
+{
+    struct rio_rq *rq = (struct rio_rq *)handle;
+    struct sockaddr *addr = NULL;
+    struct rio_request *request;
+    WSABUF buffer = {0};
+    int addr_len = 0;
+
+    TRACE( "rq %p, data %p, count %lu, local_addr %p, remote_addr %p, control %p, flags_buf %p, "
+           "flags %#lx, context %p\n", rq, data, count, local_addr, remote_addr, control,
+           flags_buf, flags, context );
+
+    if (!rq || count > 1 || (count && !data) || (flags & ~(RIO_MSG_DONT_NOTIFY | RIO_MSG_DEFER
+            | RIO_MSG_COMMIT_ONLY)))
+    {
+        SetLastError( WSAEINVAL );
+        return FALSE;
+    }
+    if (flags & RIO_MSG_COMMIT_ONLY) return TRUE;
+
+    if (local_addr) FIXME( "local address not supported\n" );
+    if (control) FIXME( "control data not supported\n" );
+
+    if (count)
+    {
+        if (!(buffer.buf = rio_buffer_ptr( data, 0 ))) goto invalid;
+        buffer.len = data->Length;
+    }
+    if (remote_addr)
+    {
+        if (!(addr = (struct sockaddr *)rio_buffer_ptr( remote_addr, sizeof(SOCKADDR_INET) ))) goto invalid;
+        addr_len = addr->sa_family == AF_INET6 ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    }
+
+    if (!(request = rio_request_get( rq, TRUE, flags, context ))) return FALSE;
+    request->data = buffer;
+    request->flags_out = NULL;
+
+    return rio_request_submit( rq, request, WS2_sendto( rq->socket, &request->data, 1, NULL, 0,
+                                                        addr, addr_len, &request->ovl, NULL ) );
+
+invalid:
+    SetLastError( WSAEINVAL );
+    return FALSE;
+}
+
+/***********************************************************************
+ *     RIOSend
+ */
+static BOOL WINAPI WS2_RIOSend( RIO_RQ rq, RIO_BUF *data, ULONG count, DWORD flags, void *context )
+{
+    return WS2_RIOSendEx( rq, data, count, NULL, NULL, NULL, NULL, flags, context );
+}
+
+
 /***********************************************************************
  *      bind   (ws2_32.2)
  */
@@ -1218,6 +1978,7 @@ int WINAPI closesocket( SOCKET s )
         return -1;
     }
 
+    rio_close_socket( s );
     CloseHandle( (HANDLE)s );
     return 0;
 }
@@ -1978,6 +2739,25 @@ int WINAPI getsockopt( SOCKET s, int level, int optname, char *optval, int *optl
             return -1;
         }
 
+    case IPPROTO_UDP:
+        switch(optname)
+        {
+        case UDP_SEND_MSG_SIZE:
+            if (*optlen < sizeof(DWORD) || !optval)
+            {
+                *optlen = 0;
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            *optlen = sizeof(DWORD);
+            return server_getsockopt( s, IOCTL_AFD_WINE_GET_UDP_SEND_MSG_SIZE, optval, optlen );
+
+        default:
+            FIXME( "unrecognized UDP option %#x\n", optname );
+            SetLastError( WSAENOPROTOOPT );
+            return -1;
+        }
+
     case IPPROTO_IP:
         switch(optname)
         {
@@ -2182,6 +2962,7 @@ static const char *debugstr_wsaioctl(DWORD code)
         IOCTL_NAME(SIO_GET_EXTENSION_FUNCTION_POINTER);
         IOCTL_NAME(SIO_GET_GROUP_QOS);
         IOCTL_NAME(SIO_GET_INTERFACE_LIST);
+        IOCTL_NAME(SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER);
         /* IOCTL_NAME(SIO_GET_INTERFACE_LIST_EX); */
         IOCTL_NAME(SIO_GET_QOS);
         IOCTL_NAME(SIO_IDEAL_SEND_BACKLOG_CHANGE);
@@ -2555,6 +3336,52 @@ INT WINAPI WSAIoctl(SOCKET s, DWORD code, LPVOID in_buff, DWORD in_size, LPVOID
         return -1;
     }
 
+    case SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER:
+    {
+        static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+        static const RIO_EXTENSION_FUNCTION_TABLE rio_funcs =
+        {
+            sizeof(RIO_EXTENSION_FUNCTION_TABLE),
+            WS2_RIOReceive,
+            WS2_RIOReceiveEx,
+            WS2_RIOSend,
+            WS2_RIOSendEx,
+            WS2_RIOCloseCompletionQueue,
+            WS2_RIOCreateCompletionQueue,
+            WS2_RIOCreateRequestQueue,
+            WS2_RIODequeueCompletion,
+            WS2_RIODeregisterBuffer,
+            WS2_RIONotify,
+            WS2_RIORegisterBuffer,
+            WS2_RIOResizeCompletionQueue,
+            WS2_RIOResizeRequestQueue,
+        };
+        NTSTATUS status = STATUS_SUCCESS;
+        DWORD ret;
+
+        if (!in_buff || in_size < sizeof(GUID) || !IsEqualGUID( &rio_guid, in_buff ))
+        {
+            FIXME( "SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER %s: stub\n",
+                   in_buff && in_size >= sizeof(GUID) ? debugstr_guid(in_buff) : "(null)" );
+            SetLastError( WSAEINVAL );
+            return -1;
+        }
+        if (!out_buff || out_size < sizeof(rio_funcs))
+        {
+            SetLastError( WSAEFAULT );
+            return -1;
+        }
+
+        TRACE( "returning RIO function table\n" );
+        memcpy( out_buff, &rio_funcs, sizeof(rio_funcs) );
+
+        ret = server_ioctl_sock( s, IOCTL_AFD_WINE_COMPLETE_ASYNC, &status, sizeof(status),
+                                 NULL, 0, ret_size, overlapped, completion );
+        *ret_size = sizeof(rio_funcs);
+        SetLastError( ret );
+        return ret ? -1 : 0;
+    }
+
     case SIO_KEEPALIVE_VALS:
     {
         DWORD ret;
@@ -3417,6 +4244,31 @@ int WINAPI setsockopt( SOCKET s, int level, int optname, const char *optval, int
         }
         break;
 
+    case IPPROTO_UDP:
+        if (optlen < 0)
+        {
+            SetLastError(WSAEFAULT);
+            return SOCKET_ERROR;
+        }
+
+        switch(optname)
+        {
+        case UDP_SEND_MSG_SIZE:
+            if (optlen < sizeof(DWORD) || !optval)
+            {
+                SetLastError( WSAEFAULT );
+                return SOCKET_ERROR;
+            }
+            value = *(DWORD*)optval;
+            return server_setsockopt( s, IOCTL_AFD_WINE_SET_UDP_SEND_MSG_SIZE, (char*)&value, sizeof(value) );
+
+        default:
+            FIXME("Unknown IPPROTO_UDP optname 0x%08x\n", optname);
+            SetLastError(WSAENOPROTOOPT);
+            return SOCKET_ERROR;
+        }
+        break;
+
     case IPPROTO_IP:
         if (optlen < 0)
         {
@@ -3977,6 +4829,9 @@ SOCKET WINAPI WSASocketW(int af, int type, int protocol,
         }
     }
 
+    /* registered I/O is built on overlapped requests, which must not block */
+    if (flags & WSA_FLAG_REGISTERED_IO) flags |= WSA_FLAG_OVERLAPPED;
+
     InitializeObjectAttributes(&attr, &string, (flags & WSA_FLAG_NO_HANDLE_INHERIT) ? 0 : OBJ_INHERIT, NULL, NULL);
     if ((status = NtOpenFile(&handle, GENERIC_READ | GENERIC_WRITE | SYNCHRONIZE, &attr,
             &io, 0, (flags & WSA_FLAG_OVERLAPPED) ? 0 : FILE_SYNCHRONOUS_IO_NONALERT)))
@@ -1487,6 +1487,25 @@ static void test_set_getsockopt(void)
         ok(value == 5, "TCP_KEEPINTVL should be 5, is %ld\n", value);
     }
 
+    /* UDP_SEND_MSG_SIZE needs segmentation offload support in the stack */
+    s2 = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ok(s2 != INVALID_SOCKET, "failed to create socket, error %u\n", WSAGetLastError());
+    value = 1000;
+    err = setsockopt(s2, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, sizeof(value));
+    ok(!err || WSAGetLastError() == WSAENOPROTOOPT || WSAGetLastError() == WSAEINVAL,
+       "setsockopt UDP_SEND_MSG_SIZE failed: %d\n", WSAGetLastError());
+    if (!err)
+    {
+        size = sizeof(value);
+        value = 0;
+        err = getsockopt(s2, IPPROTO_UDP, UDP_SEND_MSG_SIZE, (char *)&value, &size);
+        ok(!err, "getsockopt UDP_SEND_MSG_SIZE failed: %d\n", WSAGetLastError());
+        ok(value == 1000, "UDP_SEND_MSG_SIZE should be 1000, is %ld\n", value);
+        ok(size == sizeof(value), "got size %d\n", size);
+    }
+    else skip("UDP_SEND_MSG_SIZE is not supported\n");
+    closesocket(s2);
+
     /* Test for erroneously passing a value instead of a pointer as optval */
     size = sizeof(char);
     err = setsockopt(s, SOL_SOCKET, SO_DONTROUTE, (char *)1, size);
@@ -13287,6 +13306,78 @@ static void test_simultaneous_async_recv(void)
     for (i = 0; i < num_io; i++) CloseHandle(events[i]);
 }
 
+static void test_simultaneous_async_recvfrom(void)
+{
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    struct sockaddr_in client_addr, from[8];
+    OVERLAPPED overlappeds[8] = {{0}};
+    int from_len[8], ret, len;
+    char buffers[8][16], data[16];
+    DWORD flags[8] = {0}, size;
+    SOCKET client, server;
+    WSABUF wsabufs[8];
+    unsigned int i;
+
+    server = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ok(server != INVALID_SOCKET, "failed to create socket, error %u\n", WSAGetLastError());
+    ret = bind(server, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(server, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ok(client != INVALID_SOCKET, "failed to create socket, error %u\n", WSAGetLastError());
+    ret = connect(client, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u\n", WSAGetLastError());
+    len = sizeof(client_addr);
+    ret = getsockname(client, (struct sockaddr *)&client_addr, &len);
+    ok(!ret, "got error %u\n", WSAGetLastError());
+
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++)
+    {
+        wsabufs[i].buf = buffers[i];
+        wsabufs[i].len = sizeof(buffers[i]);
+        overlappeds[i].hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+        from_len[i] = sizeof(from[i]);
+        ret = WSARecvFrom(server, &wsabufs[i], 1, NULL, &flags[i], (struct sockaddr *)&from[i],
+                          &from_len[i], &overlappeds[i], NULL);
+        ok(ret == -1, "got %d\n", ret);
+        ok(WSAGetLastError() == ERROR_IO_PENDING, "got error %u\n", WSAGetLastError());
+    }
+
+    /* the datagrams are received in order, even when they are already queued */
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++)
+    {
+        sprintf(data, "datagram %u", i);
+        ret = send(client, data, strlen(data) + 1, 0);
+        ok(ret == strlen(data) + 1, "got %d\n", ret);
+    }
+
+    for (i = 0; i < ARRAY_SIZE(overlappeds); i++)
+    {
+        winetest_push_context("%u", i);
+
+        ret = WaitForSingleObject(overlappeds[i].hEvent, 1000);
+        ok(!ret, "wait timed out\n");
+
+        sprintf(data, "datagram %u", i);
+        size = 0;
+        ret = GetOverlappedResult((HANDLE)server, &overlappeds[i], &size, FALSE);
+        ok(ret, "got error %lu\n", GetLastError());
+        ok(size == strlen(data) + 1, "got size %lu\n", size);
+        ok(!strcmp(buffers[i], data), "got %s\n", debugstr_an(buffers[i], size));
+        ok(from_len[i] == sizeof(from[i]), "got address length %d\n", from_len[i]);
+        ok(from[i].sin_port == client_addr.sin_port, "got port %u\n", ntohs(from[i].sin_port));
+
+        CloseHandle(overlappeds[i].hEvent);
+        winetest_pop_context();
+    }
+
+    closesocket(client);
+    closesocket(server);
+}
+
 static void test_empty_recv(void)
 {
     OVERLAPPED overlapped = {0};
@@ -14376,6 +14467,193 @@ static void test_send_buffering(void)
     closesocket(client);
 }
 
+static void test_rio(void)
+{
+    static const GUID rio_guid = WSAID_MULTIPLE_RIO;
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    RIO_NOTIFICATION_COMPLETION notify = {0};
+    RIO_EXTENSION_FUNCTION_TABLE rio = {0};
+    RIO_BUF data, remote;
+    RIO_BUFFERID bufid;
+    RIORESULT results[4];
+    OVERLAPPED ov, *overlapped;
+    SOCKET s, s2, client;
+    DWORD size, flags;
+    HANDLE event, port;
+    char buffer[128];
+    ULONG_PTR key;
+    WSABUF wsabuf;
+    RIO_RQ rq, rq2;
+    RIO_CQ cq;
+    int ret, len;
+
+    s = WSASocketW(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_REGISTERED_IO);
+    ok(s != INVALID_SOCKET, "got error %u.\n", WSAGetLastError());
+
+    ret = WSAIoctl(s, SIO_GET_MULTIPLE_EXTENSION_FUNCTION_POINTER, (void *)&rio_guid, sizeof(rio_guid),
+                   &rio, sizeof(rio), &size, NULL, NULL);
+    if (ret)
+    {
+        win_skip("Registered I/O is not supported.\n");
+        closesocket(s);
+        return;
+    }
+    ok(size == sizeof(rio), "got size %lu.\n", size);
+    ok(rio.cbSize == sizeof(rio), "got cbSize %lu.\n", rio.cbSize);
+
+    ret = bind(s, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(s, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+
+    client = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    ok(client != INVALID_SOCKET, "got error %u.\n", WSAGetLastError());
+
+    event = CreateEventW(NULL, FALSE, FALSE, NULL);
+    notify.Type = RIO_EVENT_COMPLETION;
+    notify.Event.EventHandle = event;
+    notify.Event.NotifyReset = TRUE;
+
+    cq = rio.RIOCreateCompletionQueue(0, &notify);
+    ok(cq == RIO_INVALID_CQ, "got %p.\n", cq);
+    ok(WSAGetLastError() == WSAEINVAL, "got error %u.\n", WSAGetLastError());
+    cq = rio.RIOCreateCompletionQueue(4, &notify);
+    ok(cq != RIO_INVALID_CQ, "got error %u.\n", WSAGetLastError());
+
+    rq = rio.RIOCreateRequestQueue(s, 1, 1, 1, 1, cq, cq, (void *)0xdead);
+    ok(rq != RIO_INVALID_RQ, "got error %u.\n", WSAGetLastError());
+    rq2 = rio.RIOCreateRequestQueue(s, 1, 1, 1, 1, cq, cq, NULL);
+    ok(rq2 == RIO_INVALID_RQ, "got %p.\n", rq2);
+    ok(WSAGetLastError() == WSAEINVAL, "got error %u.\n", WSAGetLastError());
+
+    memset(buffer, 0, sizeof(buffer));
+    bufid = rio.RIORegisterBuffer(buffer, sizeof(buffer));
+    ok(bufid != RIO_INVALID_BUFFERID, "got error %u.\n", WSAGetLastError());
+
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(!ret, "got %d.\n", ret);
+
+    data.BufferId = bufid;
+    data.Offset = 0;
+    data.Length = 32;
+    ret = rio.RIOReceive(rq, &data, 1, 0, (void *)0x1234);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+
+    ret = rio.RIONotify(cq);
+    ok(!ret, "got %d.\n", ret);
+    ret = rio.RIONotify(cq);
+    ok(ret == WSAEALREADY, "got %d.\n", ret);
+
+    ret = sendto(client, "hello", 5, 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == 5, "got %d, error %u.\n", ret, WSAGetLastError());
+
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "got %d.\n", ret);
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(ret == 1, "got %d.\n", ret);
+    ok(!results[0].Status, "got status %ld.\n", results[0].Status);
+    ok(results[0].BytesTransferred == 5, "got %lu bytes.\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0xdead, "got socket context %#I64x.\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x1234, "got request context %#I64x.\n", results[0].RequestContext);
+    ok(!memcmp(buffer, "hello", 5), "got %s.\n", debugstr_an(buffer, 5));
+
+    /* send back to the client through a registered address buffer */
+    len = sizeof(addr);
+    ret = getsockname(client, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    memcpy(buffer + 64, &addr, sizeof(addr));
+    remote.BufferId = bufid;
+    remote.Offset = 64;
+    remote.Length = sizeof(SOCKADDR_INET);
+    memcpy(buffer + 32, "world", 5);
+    data.Offset = 32;
+    data.Length = 5;
+    ret = rio.RIOSendEx(rq, &data, 1, NULL, &remote, NULL, NULL, 0, (void *)0x5678);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+
+    ret = rio.RIONotify(cq);
+    ok(!ret, "got %d.\n", ret);
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "got %d.\n", ret);
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(ret == 1, "got %d.\n", ret);
+    ok(!results[0].Status, "got status %ld.\n", results[0].Status);
+    ok(results[0].BytesTransferred == 5, "got %lu bytes.\n", results[0].BytesTransferred);
+    ok(results[0].RequestContext == 0x5678, "got request context %#I64x.\n", results[0].RequestContext);
+
+    memset(buffer + 96, 0, 32);
+    ret = recv(client, buffer + 96, 32, 0);
+    ok(ret == 5, "got %d, error %u.\n", ret, WSAGetLastError());
+    ok(!memcmp(buffer + 96, "world", 5), "got %s.\n", debugstr_an(buffer + 96, 5));
+
+    /* a completion port associated with the socket keeps receiving the regular overlapped completions */
+    s2 = WSASocketW(AF_INET, SOCK_DGRAM, IPPROTO_UDP, NULL, 0, WSA_FLAG_OVERLAPPED | WSA_FLAG_REGISTERED_IO);
+    ok(s2 != INVALID_SOCKET, "got error %u.\n", WSAGetLastError());
+    addr.sin_port = 0;
+    ret = bind(s2, (struct sockaddr *)&addr, sizeof(addr));
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+    len = sizeof(addr);
+    ret = getsockname(s2, (struct sockaddr *)&addr, &len);
+    ok(!ret, "got error %u.\n", WSAGetLastError());
+
+    port = CreateIoCompletionPort((HANDLE)s2, NULL, 123, 0);
+    ok(!!port, "got error %lu.\n", GetLastError());
+
+    rq = rio.RIOCreateRequestQueue(s2, 1, 1, 1, 1, cq, cq, (void *)0xbeef);
+    ok(rq != RIO_INVALID_RQ, "got error %u.\n", WSAGetLastError());
+
+    data.Offset = 0;
+    data.Length = 32;
+    ret = rio.RIOReceive(rq, &data, 1, 0, (void *)0x4321);
+    ok(ret, "got error %u.\n", WSAGetLastError());
+
+    memset(&ov, 0, sizeof(ov));
+    wsabuf.buf = buffer + 96;
+    wsabuf.len = 32;
+    flags = 0;
+    ret = WSARecv(s2, &wsabuf, 1, NULL, &flags, &ov, NULL);
+    ok(ret == -1, "got %d.\n", ret);
+    ok(WSAGetLastError() == ERROR_IO_PENDING, "got error %u.\n", WSAGetLastError());
+
+    ret = sendto(client, "foo", 3, 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == 3, "got %d, error %u.\n", ret, WSAGetLastError());
+    ret = sendto(client, "bar", 3, 0, (struct sockaddr *)&addr, sizeof(addr));
+    ok(ret == 3, "got %d, error %u.\n", ret, WSAGetLastError());
+
+    key = 0xdeadbeef;
+    overlapped = NULL;
+    ret = GetQueuedCompletionStatus(port, &size, &key, &overlapped, 1000);
+    ok(ret, "got error %lu.\n", GetLastError());
+    ok(key == 123, "got key %#Ix.\n", key);
+    ok(overlapped == &ov, "got overlapped %p.\n", overlapped);
+    ok(size == 3, "got size %lu.\n", size);
+
+    ret = rio.RIONotify(cq);
+    ok(!ret, "got %d.\n", ret);
+    ret = WaitForSingleObject(event, 1000);
+    ok(!ret, "got %d.\n", ret);
+    ret = rio.RIODequeueCompletion(cq, results, ARRAY_SIZE(results));
+    ok(ret == 1, "got %d.\n", ret);
+    ok(!results[0].Status, "got status %ld.\n", results[0].Status);
+    ok(results[0].BytesTransferred == 3, "got %lu bytes.\n", results[0].BytesTransferred);
+    ok(results[0].SocketContext == 0xbeef, "got socket context %#I64x.\n", results[0].SocketContext);
+    ok(results[0].RequestContext == 0x4321, "got request context %#I64x.\n", results[0].RequestContext);
+
+    ret = GetQueuedCompletionStatus(port, &size, &key, &overlapped, 0);
+    ok(!ret, "expected failure.\n");
+    ok(GetLastError() == WAIT_TIMEOUT, "got error %lu.\n", GetLastError());
+
+    closesocket(s2);
+    CloseHandle(port);
+    closesocket(client);
+    closesocket(s);
+    rio.RIOCloseCompletionQueue(cq);
+    rio.RIODeregisterBuffer(bufid);
+    CloseHandle(event);
+}
+
 START_TEST( sock )
 {
     int i;
@@ -14452,6 +14730,7 @@ START_TEST( sock )
     test_WSAGetOverlappedResult();
     test_nonblocking_async_recv();
     test_simultaneous_async_recv();
+    test_simultaneous_async_recvfrom();
     test_empty_recv();
     test_timeout();
     test_tcp_reset();
@@ -14460,6 +14739,7 @@ START_TEST( sock )
     test_tcp_sendto_recvfrom();
     test_broadcast();
     test_send_buffering();
+    test_rio();
 
     /* There is apparently an obscure interaction between this test and
      * test_WSAGetOverlappedResult().
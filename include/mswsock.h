@@ -139,6 +139,8 @@ extern "C" {
 	{0xf689d7c8,0x6f1f,0x436b,{0x8a,0x53,0xe5,0x4f,0xe3,0x51,0xc3,0x22}}
 #define WSAID_WSASENDMSG \
 	{0xa441e712,0x754f,0x43ca,{0x84,0xa7,0x0d,0xee,0x44,0xcf,0x60,0x6d}}
+#define WSAID_MULTIPLE_RIO \
+	{0x8509e081,0x96dd,0x4005,{0xb1,0x65,0x9e,0x2e,0xe8,0xc7,0x9e,0x3f}}
 
 typedef struct _TRANSMIT_FILE_BUFFERS {
     LPVOID  Head;
@@ -159,6 +161,55 @@ typedef struct _TRANSMIT_PACKETS_ELEMENT {
     } DUMMYUNIONNAME;
 } TRANSMIT_PACKETS_ELEMENT, *PTRANSMIT_PACKETS_ELEMENT, *LPTRANSMIT_PACKETS_ELEMENT;
 
+#define RIO_MSG_DONT_NOTIFY     0x00000001
+#define RIO_MSG_DEFER           0x00000002
+#define RIO_MSG_WAITALL         0x00000004
+#define RIO_MSG_COMMIT_ONLY     0x00000008
+
+#define RIO_INVALID_BUFFERID    ((RIO_BUFFERID)(ULONG_PTR)0xffffffff)
+#define RIO_INVALID_CQ          ((RIO_CQ)0)
+#define RIO_INVALID_RQ          ((RIO_RQ)0)
+
+#define RIO_MAX_CQ_SIZE         0x8000000
+#define RIO_CORRUPT_CQ          0xffffffff
+
+typedef struct RIO_BUFFERID_t *RIO_BUFFERID, **PRIO_BUFFERID;
+typedef struct RIO_CQ_t *RIO_CQ, **PRIO_CQ;
+typedef struct RIO_RQ_t *RIO_RQ, **PRIO_RQ;
+
+typedef struct _RIORESULT {
+    LONG      Status;
+    ULONG     BytesTransferred;
+    ULONGLONG SocketContext;
+    ULONGLONG RequestContext;
+} RIORESULT, *PRIORESULT;
+
+typedef struct _RIO_BUF {
+    RIO_BUFFERID BufferId;
+    ULONG        Offset;
+    ULONG        Length;
+} RIO_BUF, *PRIO_BUF;
+
+typedef enum _RIO_NOTIFICATION_COMPLETION_TYPE {
+    RIO_EVENT_COMPLETION = 1,
+    RIO_IOCP_COMPLETION  = 2,
+} RIO_NOTIFICATION_COMPLETION_TYPE, *PRIO_NOTIFICATION_COMPLETION_TYPE;
+
+typedef struct _RIO_NOTIFICATION_COMPLETION {
+    RIO_NOTIFICATION_COMPLETION_TYPE Type;
+    union {
+        struct {
+            HANDLE EventHandle;
+            BOOL   NotifyReset;
+        } Event;
+        struct {
+            HANDLE IocpHandle;
+            PVOID  CompletionKey;
+            PVOID  Overlapped;
+        } Iocp;
+    } DUMMYUNIONNAME;
+} RIO_NOTIFICATION_COMPLETION, *PRIO_NOTIFICATION_COMPLETION;
+
 typedef struct _WSACMSGHDR {
     SIZE_T      cmsg_len;
     INT         cmsg_level;
@@ -246,6 +297,37 @@ typedef BOOL (WINAPI * LPFN_TRANSMITPACKETS)(SOCKET, LPTRANSMIT_PACKETS_ELEMENT,
 typedef INT  (WINAPI * LPFN_WSARECVMSG)(SOCKET, LPWSAMSG, LPDWORD, LPWSAOVERLAPPED, LPWSAOVERLAPPED_COMPLETION_ROUTINE);
 typedef INT  (WINAPI * LPFN_WSASENDMSG)(SOCKET, LPWSAMSG, DWORD, LPDWORD, LPWSAOVERLAPPED, LPWSAOVERLAPPED_COMPLETION_ROUTINE);
 
+typedef BOOL         (WINAPI * LPFN_RIORECEIVE)(RIO_RQ, PRIO_BUF, ULONG, DWORD, PVOID);
+typedef int          (WINAPI * LPFN_RIORECEIVEEX)(RIO_RQ, PRIO_BUF, ULONG, PRIO_BUF, PRIO_BUF, PRIO_BUF, PRIO_BUF, DWORD, PVOID);
+typedef BOOL         (WINAPI * LPFN_RIOSEND)(RIO_RQ, PRIO_BUF, ULONG, DWORD, PVOID);
+typedef BOOL         (WINAPI * LPFN_RIOSENDEX)(RIO_RQ, PRIO_BUF, ULONG, PRIO_BUF, PRIO_BUF, PRIO_BUF, PRIO_BUF, DWORD, PVOID);
+typedef void         (WINAPI * LPFN_RIOCLOSECOMPLETIONQUEUE)(RIO_CQ);
+typedef RIO_CQ       (WINAPI * LPFN_RIOCREATECOMPLETIONQUEUE)(DWORD, PRIO_NOTIFICATION_COMPLETION);
+typedef RIO_RQ       (WINAPI * LPFN_RIOCREATEREQUESTQUEUE)(SOCKET, ULONG, ULONG, ULONG, ULONG, RIO_CQ, RIO_CQ, PVOID);
+typedef ULONG        (WINAPI * LPFN_RIODEQUEUECOMPLETION)(RIO_CQ, PRIORESULT, ULONG);
+typedef void         (WINAPI * LPFN_RIODEREGISTERBUFFER)(RIO_BUFFERID);
+typedef int          (WINAPI * LPFN_RIONOTIFY)(RIO_CQ);
+typedef RIO_BUFFERID (WINAPI * LPFN_RIOREGISTERBUFFER)(PCHAR, DWORD);
+typedef BOOL         (WINAPI * LPFN_RIORESIZECOMPLETIONQUEUE)(RIO_CQ, DWORD);
+typedef BOOL         (WINAPI * LPFN_RIORESIZEREQUESTQUEUE)(RIO_RQ, DWORD, DWORD);
+
+typedef struct _RIO_EXTENSION_FUNCTION_TABLE {
+    DWORD                         cbSize;
+    LPFN_RIORECEIVE               RIOReceive;
+    LPFN_RIORECEIVEEX             RIOReceiveEx;
+    LPFN_RIOSEND                  RIOSend;
+    LPFN_RIOSENDEX                RIOSendEx;
+    LPFN_RIOCLOSECOMPLETIONQUEUE  RIOCloseCompletionQueue;
+    LPFN_RIOCREATECOMPLETIONQUEUE RIOCreateCompletionQueue;
+    LPFN_RIOCREATEREQUESTQUEUE    RIOCreateRequestQueue;
+    LPFN_RIODEQUEUECOMPLETION     RIODequeueCompletion;
+    LPFN_RIODEREGISTERBUFFER      RIODeregisterBuffer;
+    LPFN_RIONOTIFY                RIONotify;
+    LPFN_RIOREGISTERBUFFER        RIORegisterBuffer;
+    LPFN_RIORESIZECOMPLETIONQUEUE RIOResizeCompletionQueue;
+    LPFN_RIORESIZEREQUESTQUEUE    RIOResizeRequestQueue;
+} RIO_EXTENSION_FUNCTION_TABLE, *PRIO_EXTENSION_FUNCTION_TABLE;
+
 BOOL WINAPI AcceptEx(SOCKET, SOCKET, PVOID, DWORD, DWORD, DWORD, LPDWORD, LPOVERLAPPED);
 VOID WINAPI GetAcceptExSockaddrs(PVOID, DWORD, DWORD, DWORD, struct WS(sockaddr) **, LPINT, struct WS(sockaddr) **, LPINT);
 BOOL WINAPI TransmitFile(SOCKET, HANDLE, DWORD, DWORD, LPOVERLAPPED, LPTRANSMIT_FILE_BUFFERS, DWORD);
@@ -1999,6 +1999,21 @@ struct send_socket_reply
 #define SERVER_SOCKET_IO_SYSTEM      0x02
 
 
+struct socket_alert_batch_request
+{
+    struct request_header __header;
+    obj_handle_t handle;
+    client_ptr_t user;
+    int          write;
+    char __pad_28[4];
+};
+struct socket_alert_batch_reply
+{
+    struct reply_header __header;
+    /* VARARG(users,uints64); */
+};
+
+
 struct socket_get_events_request
 {
     struct request_header __header;
@@ -5960,6 +5975,7 @@ enum request
     REQ_unlock_file,
     REQ_recv_socket,
     REQ_send_socket,
+    REQ_socket_alert_batch,
     REQ_socket_get_events,
     REQ_socket_send_icmp_id,
     REQ_socket_get_icmp_id,
@@ -6260,6 +6276,7 @@ union generic_request
     struct unlock_file_request unlock_file_request;
     struct recv_socket_request recv_socket_request;
     struct send_socket_request send_socket_request;
+    struct socket_alert_batch_request socket_alert_batch_request;
     struct socket_get_events_request socket_get_events_request;
     struct socket_send_icmp_id_request socket_send_icmp_id_request;
     struct socket_get_icmp_id_request socket_get_icmp_id_request;
@@ -6558,6 +6575,7 @@ union generic_reply
     struct unlock_file_reply unlock_file_reply;
     struct recv_socket_reply recv_socket_reply;
     struct send_socket_reply send_socket_reply;
+    struct socket_alert_batch_reply socket_alert_batch_reply;
     struct socket_get_events_reply socket_get_events_reply;
     struct socket_send_icmp_id_reply socket_send_icmp_id_reply;
     struct socket_get_icmp_id_reply socket_get_icmp_id_reply;
@@ -6796,6 +6814,6 @@ union generic_reply
     struct set_keyboard_repeat_reply set_keyboard_repeat_reply;
 };
 
-#define SERVER_PROTOCOL_VERSION 859
+#define SERVER_PROTOCOL_VERSION 860
 
 #endif /* __WINE_WINE_SERVER_PROTOCOL_H */
@@ -0,0 +1,57 @@
+/*
+ * Word-at-a-time string scanning helpers
+ *
+ * Copyright 2026 the Wine project authors
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301, USA
+ */
+
+#ifndef __WINE_WINE_WORDSCAN_H
+#define __WINE_WINE_WORDSCAN_H
+
+#include <windef.h>
+
+/* Strings are scanned one aligned machine word at a time. An aligned word
+ * never crosses a page boundary, so reading past the terminator within the
+ * last word is safe. */
+
+#define WORD_ONES  (~(size_t)0 / 0xff)
+#define WORD_HIGHS (WORD_ONES << 7)
+
+#define WORD_WCHAR_ONES  (~(size_t)0 / 0xffff)
+#define WORD_WCHAR_HIGHS (WORD_WCHAR_ONES << 15)
+
+static inline BOOL word_is_aligned( const void *ptr )
+{
+    return !((ULONG_PTR)ptr & (sizeof(size_t) - 1));
+}
+
+/* a word with every byte set to c, to look for it with word_has_zero_byte( w ^ mask ) */
+static inline size_t word_byte_mask( unsigned char c )
+{
+    return WORD_ONES * c;
+}
+
+static inline BOOL word_has_zero_byte( size_t v )
+{
+    return ((v - WORD_ONES) & ~v & WORD_HIGHS) != 0;
+}
+
+static inline BOOL word_has_zero_wchar( size_t v )
+{
+    return ((v - WORD_WCHAR_ONES) & ~v & WORD_WCHAR_HIGHS) != 0;
+}
+
+#endif  /* __WINE_WINE_WORDSCAN_H */
@@ -16,6 +16,10 @@
 
 #ifdef LTC_SHA1
 
+#ifdef LTC_SHANI
+#include <immintrin.h>
+#endif
+
 const struct ltc_hash_descriptor sha1_desc =
 {
     "sha1",
@@ -39,6 +43,96 @@ const struct ltc_hash_descriptor sha1_desc =
 #define F2(x,y,z)  ((x & y) | (z & (x | y)))
 #define F3(x,y,z)  (x ^ y ^ z)
 
+#ifdef LTC_SHANI
+/* compress 512-bits with the SHA extensions */
+__attribute__((target("sha,sse4.1")))
+static void sha1_compress_shani(hash_state *md, const unsigned char *buf)
+{
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    __m128i abcd, abcd_save, e0, e0_save, e1, w0, w1, w2, w3;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)md->sha1.state), 0x1b);
+    e0 = _mm_set_epi32(md->sha1.state[4], 0, 0, 0);
+    abcd_save = abcd;
+    e0_save = e0;
+
+    w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf +  0)), mask);
+    w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 16)), mask);
+    w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 32)), mask);
+    w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 48)), mask);
+
+    /* rounds 0-15 */
+    e0 = _mm_add_epi32(e0, w0);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+    e1 = _mm_sha1nexte_epu32(e1, w1);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    w0 = _mm_sha1msg1_epu32(w0, w1);
+
+    e0 = _mm_sha1nexte_epu32(e0, w2);
+    e1 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+    w1 = _mm_sha1msg1_epu32(w1, w2);
+    w0 = _mm_xor_si128(w0, w2);
+
+    e1 = _mm_sha1nexte_epu32(e1, w3);
+    e0 = abcd;
+    w0 = _mm_sha1msg2_epu32(w0, w3);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 0);
+    w2 = _mm_sha1msg1_epu32(w2, w3);
+    w1 = _mm_xor_si128(w1, w3);
+
+#define RND4(e, e_next, w0, w1, w2, w3, f)                                   \
+    e = _mm_sha1nexte_epu32(e, w0);                                          \
+    e_next = abcd;                                                           \
+    w1 = _mm_sha1msg2_epu32(w1, w0);                                         \
+    abcd = _mm_sha1rnds4_epu32(abcd, e, f);                                  \
+    w3 = _mm_sha1msg1_epu32(w3, w0);                                         \
+    w2 = _mm_xor_si128(w2, w0);
+
+    /* rounds 16-67 */
+    RND4(e0, e1, w0, w1, w2, w3, 0);
+    RND4(e1, e0, w1, w2, w3, w0, 1);
+    RND4(e0, e1, w2, w3, w0, w1, 1);
+    RND4(e1, e0, w3, w0, w1, w2, 1);
+    RND4(e0, e1, w0, w1, w2, w3, 1);
+    RND4(e1, e0, w1, w2, w3, w0, 1);
+    RND4(e0, e1, w2, w3, w0, w1, 2);
+    RND4(e1, e0, w3, w0, w1, w2, 2);
+    RND4(e0, e1, w0, w1, w2, w3, 2);
+    RND4(e1, e0, w1, w2, w3, w0, 2);
+    RND4(e0, e1, w2, w3, w0, w1, 2);
+    RND4(e1, e0, w3, w0, w1, w2, 3);
+    RND4(e0, e1, w0, w1, w2, w3, 3);
+
+#undef RND4
+
+    /* rounds 68-79 */
+    e1 = _mm_sha1nexte_epu32(e1, w1);
+    e0 = abcd;
+    w2 = _mm_sha1msg2_epu32(w2, w1);
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+    w3 = _mm_xor_si128(w3, w1);
+
+    e0 = _mm_sha1nexte_epu32(e0, w2);
+    e1 = abcd;
+    w3 = _mm_sha1msg2_epu32(w3, w2);
+    abcd = _mm_sha1rnds4_epu32(abcd, e0, 3);
+
+    e1 = _mm_sha1nexte_epu32(e1, w3);
+    e0 = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e1, 3);
+
+    e0 = _mm_sha1nexte_epu32(e0, e0_save);
+    abcd = _mm_add_epi32(abcd, abcd_save);
+
+    _mm_storeu_si128((__m128i *)md->sha1.state, _mm_shuffle_epi32(abcd, 0x1b));
+    md->sha1.state[4] = _mm_extract_epi32(e0, 3);
+}
+#endif
+
 #ifdef LTC_CLEAN_STACK
 static int _sha1_compress(hash_state *md, unsigned char *buf)
 #else
@@ -50,6 +144,13 @@ static int  sha1_compress(hash_state *md, unsigned char *buf)
     ulong32 t;
 #endif
 
+#ifdef LTC_SHANI
+    if (cpu_has_shani()) {
+        sha1_compress_shani(md, buf);
+        return CRYPT_OK;
+    }
+#endif
+
     /* copy the state into 512-bits into W[0..15] */
     for (i = 0; i < 16; i++) {
         LOAD32H(W[i], buf + (4*i));
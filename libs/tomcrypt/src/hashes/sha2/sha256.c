@@ -15,6 +15,10 @@
 
 #ifdef LTC_SHA256
 
+#ifdef LTC_SHANI
+#include <immintrin.h>
+#endif
+
 const struct ltc_hash_descriptor sha256_desc =
 {
     "sha256",
@@ -33,7 +37,7 @@ const struct ltc_hash_descriptor sha256_desc =
     NULL
 };
 
-#ifdef LTC_SMALL_CODE
+#if defined(LTC_SMALL_CODE) || defined(LTC_SHANI)
 /* the K array */
 static const ulong32 K[64] = {
     0x428a2f98UL, 0x71374491UL, 0xb5c0fbcfUL, 0xe9b5dba5UL, 0x3956c25bUL,
@@ -62,6 +66,61 @@ static const ulong32 K[64] = {
 #define Gamma0(x)       (S(x, 7) ^ S(x, 18) ^ R(x, 3))
 #define Gamma1(x)       (S(x, 17) ^ S(x, 19) ^ R(x, 10))
 
+#ifdef LTC_SHANI
+/* compress 512-bits with the SHA extensions */
+__attribute__((target("sha,sse4.1")))
+static void sha256_compress_shani(hash_state * md, const unsigned char *buf)
+{
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+    __m128i state0, state1, abef, cdgh, msg, tmp, w0, w1, w2, w3;
+    int i;
+
+    /* the instructions work on ABEF and CDGH */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&md->sha256.state[0]), 0xb1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)&md->sha256.state[4]), 0x1b);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+    abef = state0;
+    cdgh = state1;
+
+    w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf +  0)), mask);
+    w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 16)), mask);
+    w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 32)), mask);
+    w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(buf + 48)), mask);
+
+#define RND4(w, k)                                                           \
+    msg = _mm_add_epi32(w, _mm_loadu_si128((const __m128i *)&K[k]));         \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, msg);                     \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(msg, 0x0e));
+#define SCHED4(w0, w1, w2, w3)                                               \
+    w0 = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w0, w1),    \
+                                            _mm_alignr_epi8(w3, w2, 4)), w3);
+
+    for (i = 0; i < 48; i += 16) {
+        RND4(w0, i);      SCHED4(w0, w1, w2, w3);
+        RND4(w1, i + 4);  SCHED4(w1, w2, w3, w0);
+        RND4(w2, i + 8);  SCHED4(w2, w3, w0, w1);
+        RND4(w3, i + 12); SCHED4(w3, w0, w1, w2);
+    }
+    RND4(w0, 48);
+    RND4(w1, 52);
+    RND4(w2, 56);
+    RND4(w3, 60);
+
+#undef SCHED4
+#undef RND4
+
+    state0 = _mm_add_epi32(state0, abef);
+    state1 = _mm_add_epi32(state1, cdgh);
+
+    /* back to ABCD and EFGH */
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    _mm_storeu_si128((__m128i *)&md->sha256.state[0], _mm_blend_epi16(tmp, state1, 0xf0));
+    _mm_storeu_si128((__m128i *)&md->sha256.state[4], _mm_alignr_epi8(state1, tmp, 8));
+}
+#endif
+
 /* compress 512-bits */
 #ifdef LTC_CLEAN_STACK
 static int _sha256_compress(hash_state * md, unsigned char *buf)
@@ -75,6 +134,13 @@ static int  sha256_compress(hash_state * md, unsigned char *buf)
 #endif
     int i;
 
+#ifdef LTC_SHANI
+    if (cpu_has_shani()) {
+        sha256_compress_shani(md, buf);
+        return CRYPT_OK;
+    }
+#endif
+
     /* copy state into S */
     for (i = 0; i < 8; i++) {
         S[i] = md->sha256.state[i];
@@ -58,6 +58,12 @@ int mem_neq(const void *a, const void *b, size_t len);
 void zeromem(volatile void *dst, size_t len);
 void burn_stack(unsigned long len);
 
+/* ---- CPU features ---- */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define LTC_SHANI
+int cpu_has_shani(void);
+#endif
+
 const char *error_to_string(int err);
 
 extern const char *crypt_build_settings;
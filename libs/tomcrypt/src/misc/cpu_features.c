@@ -0,0 +1,37 @@
+/* LibTomCrypt, modular cryptographic library -- Tom St Denis
+ *
+ * LibTomCrypt is a library that provides various cryptographic
+ * algorithms in a highly modular and flexible manner.
+ *
+ * The library is free for all purposes without any express
+ * guarantee it works.
+ */
+#include "tomcrypt.h"
+
+/**
+   @file cpu_features.c
+   Runtime detection of the CPU extensions used by the hashes
+*/
+
+#ifdef LTC_SHANI
+#include <cpuid.h>
+
+/**
+   Check whether the CPU supports the x86 SHA extensions
+   @return 1 if SHA-NI and SSE4.1 are available, 0 otherwise
+*/
+int cpu_has_shani(void)
+{
+   static int have_shani = -1;
+   unsigned int eax, ebx, ecx, edx;
+
+   if (have_shani == -1) {
+      have_shani = 0;
+      if (__get_cpuid_max(0, NULL) >= 7 && __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & (1 << 19))) {
+         __cpuid_count(7, 0, eax, ebx, ecx, edx);
+         have_shani = (ebx >> 29) & 1;
+      }
+   }
+   return have_shani;
+}
+#endif
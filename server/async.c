@@ -687,6 +687,31 @@ void async_wake_up( struct async_queue *queue, unsigned int status )
     }
 }
 
+/* alert the asyncs of the current thread that are queued right after an alerted one,
+ * so that the client can perform their I/O in a batch; returns their user data */
+data_size_t async_alert_batch( struct async_queue *queue, client_ptr_t user, client_ptr_t *users,
+                               data_size_t count )
+{
+    struct async *async, *next;
+    data_size_t ret = 0;
+    int found = 0;
+
+    LIST_FOR_EACH_ENTRY_SAFE( async, next, &queue->queue, struct async, queue_entry )
+    {
+        if (!found)
+        {
+            found = async->thread == current && async->alerted && async->data.user == user;
+            continue;
+        }
+        if (ret == count || async->thread != current) break;
+        /* the client expects an APC for each of them */
+        if (async->terminated || async->canceled || async->direct_result || async->is_system) break;
+        users[ret++] = async->data.user;
+        async_terminate( async, STATUS_ALERTED );
+    }
+    return ret;
+}
+
 static void iosb_dump( struct object *obj, int verbose );
 static void iosb_destroy( struct object *obj );
 
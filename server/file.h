@@ -272,6 +272,8 @@ extern void async_request_complete( struct async *async, unsigned int status, da
 extern void async_request_complete_alloc( struct async *async, unsigned int status, data_size_t result,
                                           data_size_t out_size, const void *out_data );
 extern void async_wake_up( struct async_queue *queue, unsigned int status );
+extern data_size_t async_alert_batch( struct async_queue *queue, client_ptr_t user, client_ptr_t *users,
+                                      data_size_t count );
 extern struct completion *fd_get_completion( struct fd *fd, apc_param_t *p_key );
 extern void fd_copy_completion( struct fd *src, struct fd *dst );
 extern struct iosb *async_get_iosb( struct async *async );
@@ -966,8 +966,10 @@ static void message_queue_read( struct pipe_end *pipe_end, struct async *async )
         out_size = min( iosb->out_size, avail );
     }
 
+    /* fast path: the read consumes exactly the whole first message, even if the reader's
+     * buffer is larger, so hand over the written data without copying it */
     message = LIST_ENTRY( list_head(&pipe_end->message_queue), struct pipe_message, entry );
-    if (!message->read_pos && message->iosb->in_size == iosb->out_size) /* fast path */
+    if (!message->read_pos && message->iosb->in_size == out_size)
     {
         async_request_complete( async, status, out_size, out_size, message->iosb->in_data );
         message->iosb->in_data = NULL;
@@ -64,6 +64,7 @@ DECL_HANDLER(lock_file);
 DECL_HANDLER(unlock_file);
 DECL_HANDLER(recv_socket);
 DECL_HANDLER(send_socket);
+DECL_HANDLER(socket_alert_batch);
 DECL_HANDLER(socket_get_events);
 DECL_HANDLER(socket_send_icmp_id);
 DECL_HANDLER(socket_get_icmp_id);
@@ -361,6 +362,7 @@ static const req_handler req_handlers[REQ_NB_REQUESTS] =
     (req_handler)req_unlock_file,
     (req_handler)req_recv_socket,
     (req_handler)req_send_socket,
+    (req_handler)req_socket_alert_batch,
     (req_handler)req_socket_get_events,
     (req_handler)req_socket_send_icmp_id,
     (req_handler)req_socket_get_icmp_id,
@@ -1006,6 +1008,11 @@ C_ASSERT( offsetof(struct send_socket_reply, wait) == 8 );
 C_ASSERT( offsetof(struct send_socket_reply, options) == 12 );
 C_ASSERT( offsetof(struct send_socket_reply, nonblocking) == 16 );
 C_ASSERT( sizeof(struct send_socket_reply) == 24 );
+C_ASSERT( offsetof(struct socket_alert_batch_request, handle) == 12 );
+C_ASSERT( offsetof(struct socket_alert_batch_request, user) == 16 );
+C_ASSERT( offsetof(struct socket_alert_batch_request, write) == 24 );
+C_ASSERT( sizeof(struct socket_alert_batch_request) == 32 );
+C_ASSERT( sizeof(struct socket_alert_batch_reply) == 8 );
 C_ASSERT( offsetof(struct socket_get_events_request, handle) == 12 );
 C_ASSERT( offsetof(struct socket_get_events_request, event) == 16 );
 C_ASSERT( sizeof(struct socket_get_events_request) == 24 );
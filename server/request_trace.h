@@ -772,6 +772,18 @@ static void dump_send_socket_reply( const struct send_socket_reply *req )
     fprintf( stderr, ", nonblocking=%d", req->nonblocking );
 }
 
+static void dump_socket_alert_batch_request( const struct socket_alert_batch_request *req )
+{
+    fprintf( stderr, " handle=%04x", req->handle );
+    dump_uint64( ", user=", &req->user );
+    fprintf( stderr, ", write=%d", req->write );
+}
+
+static void dump_socket_alert_batch_reply( const struct socket_alert_batch_reply *req )
+{
+    dump_varargs_uints64( " users=", cur_size );
+}
+
 static void dump_socket_get_events_request( const struct socket_get_events_request *req )
 {
     fprintf( stderr, " handle=%04x", req->handle );
@@ -3418,6 +3430,7 @@ static const dump_func req_dumpers[REQ_NB_REQUESTS] =
     (dump_func)dump_unlock_file_request,
     (dump_func)dump_recv_socket_request,
     (dump_func)dump_send_socket_request,
+    (dump_func)dump_socket_alert_batch_request,
     (dump_func)dump_socket_get_events_request,
     (dump_func)dump_socket_send_icmp_id_request,
     (dump_func)dump_socket_get_icmp_id_request,
@@ -3715,6 +3728,7 @@ static const dump_func reply_dumpers[REQ_NB_REQUESTS] =
     NULL,
     (dump_func)dump_recv_socket_reply,
     (dump_func)dump_send_socket_reply,
+    (dump_func)dump_socket_alert_batch_reply,
     (dump_func)dump_socket_get_events_reply,
     NULL,
     (dump_func)dump_socket_get_icmp_id_reply,
@@ -4012,6 +4026,7 @@ static const char * const req_names[REQ_NB_REQUESTS] =
     "unlock_file",
     "recv_socket",
     "send_socket",
+    "socket_alert_batch",
     "socket_get_events",
     "socket_send_icmp_id",
     "socket_get_icmp_id",
@@ -258,6 +258,7 @@ struct sock
     struct accept_req  *accept_recv_req; /* pending accept-into request which will recv on this socket */
     struct connect_req *connect_req; /* pending connection request */
     struct poll_req    *main_poll;   /* main poll */
+    unsigned int        poll_index;  /* first entry of the socket in the poll request being queued */
     union win_sockaddr  addr;        /* socket name */
     int                 addr_len;    /* socket name length */
     union win_sockaddr  peer_addr;   /* peer name */
@@ -1752,6 +1753,7 @@ static struct sock *create_socket(void)
     sock->accept_recv_req = NULL;
     sock->connect_req = NULL;
     sock->main_poll = NULL;
+    sock->poll_index = 0;
     memset( &sock->addr, 0, sizeof(sock->addr) );
     sock->addr_len = 0;
     memset( &sock->peer_addr, 0, sizeof(sock->peer_addr) );
@@ -3489,6 +3491,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
                          unsigned int count, const struct afd_poll_socket_64 *sockets )
 {
     BOOL signaled = FALSE;
+    struct pollfd *pollfds;
     struct poll_req *req;
     unsigned int i, j;
 
@@ -3498,8 +3501,14 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         return;
     }
 
+    if (!(pollfds = mem_alloc( count * sizeof(*pollfds) )))
+        return;
+
     if (!(req = mem_alloc( offsetof( struct poll_req, sockets[count] ) )))
+    {
+        free( pollfds );
         return;
+    }
 
     req->timeout = NULL;
     req->pending = 0;
@@ -3507,6 +3516,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         !(req->timeout = add_timeout_user( timeout, async_poll_timeout, req )))
     {
         free( req );
+        free( pollfds );
         return;
     }
     req->orig_timeout = timeout;
@@ -3519,6 +3529,7 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
             for (j = 0; j < i; ++j) release_object( req->sockets[j].sock );
             if (req->timeout) remove_timeout_user( req->timeout );
             free( req );
+            free( pollfds );
             return;
         }
         req->sockets[i].handle = sockets[i].socket;
@@ -3537,15 +3548,41 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
     async_set_completion_callback( async, free_poll_req, req );
     queue_async( &poll_sock->poll_q, async );
 
+    /* query the current state of all the sockets with a single poll() call,
+     * falling back to polling them one at a time if that fails */
+    for (i = 0; i < count; ++i) req->sockets[i].sock->poll_index = count;
+    for (i = 0; i < count; ++i)
+    {
+        struct sock *sock = req->sockets[i].sock;
+
+        pollfds[i].fd = -1;
+        pollfds[i].events = 0;
+        pollfds[i].revents = 0;
+        if (sock->poll_index != count) continue;
+        sock->poll_index = i;
+        pollfds[i].fd = get_unix_fd( sock->fd );
+        pollfds[i].events = poll_flags_from_afd( sock, req->sockets[i].mask );
+        if (pollfds[i].events < 0) pollfds[i].fd = -1;
+    }
+    if (poll( pollfds, count, 0 ) < 0)
+        for (i = 0; i < count; ++i) req->sockets[i].sock->poll_index = count;
+
     for (i = 0; i < count; ++i)
     {
         struct sock *sock = req->sockets[i].sock;
         int mask = req->sockets[i].mask;
         struct pollfd pollfd;
 
-        pollfd.fd = get_unix_fd( sock->fd );
-        pollfd.events = poll_flags_from_afd( sock, mask );
-        if (pollfd.events >= 0 && poll( &pollfd, 1, 0 ) >= 0)
+        /* poll again sockets listed more than once, as processing the earlier
+         * entry may have changed their state */
+        if (sock->poll_index == i) pollfd = pollfds[i];
+        else
+        {
+            pollfd.fd = get_unix_fd( sock->fd );
+            pollfd.events = poll_flags_from_afd( sock, mask );
+            if (pollfd.events >= 0 && poll( &pollfd, 1, 0 ) < 0) pollfd.events = -1;
+        }
+        if (pollfd.events >= 0)
             sock_poll_event( sock->fd, pollfd.revents );
 
         /* FIXME: do other error conditions deserve a similar treatment? */
@@ -3556,6 +3593,8 @@ static void poll_socket( struct sock *poll_sock, struct async *async, int exclus
         }
     }
 
+    free( pollfds );
+
     for (i = 0; i < count; ++i)
     {
         if (req->sockets[i].flags)
@@ -4061,6 +4100,23 @@ DECL_HANDLER(send_socket)
     release_object( sock );
 }
 
+DECL_HANDLER(socket_alert_batch)
+{
+    struct sock *sock = (struct sock *)get_handle_obj( current->process, req->handle, 0, &sock_ops );
+    client_ptr_t users[16];
+    data_size_t count = min( get_reply_max_size() / sizeof(*users), ARRAY_SIZE(users) );
+
+    if (!sock) return;
+
+    /* datagrams are independent, so they can be received or sent in any batch */
+    if (sock->type == WS_SOCK_DGRAM)
+    {
+        count = async_alert_batch( req->write ? &sock->write_q : &sock->read_q, req->user, users, count );
+        set_reply_data( users, count * sizeof(*users) );
+    }
+    release_object( sock );
+}
+
 DECL_HANDLER(socket_get_events)
 {
     struct sock *sock = (struct sock *)get_handle_obj( current->process, req->handle, 0, &sock_ops );